@@ -1,4 +1,5 @@
 #include "FileCache.h"
+#include "Settings.h"
 #include "Singletons.h"
 #include "editors/EditorManager.h"
 #include "editors/binary/BinaryEditor.h"
@@ -6,16 +7,23 @@
 #include "editors/texture/TextureEditor.h"
 #include "session/SessionModel.h"
 #include "media/MediaManager.h"
+#include "render/ShaderBase.h"
+#include <QElapsedTimer>
+#include <QRegularExpression>
 #include <QTextStream>
 #include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 #if defined(MULTIMEDIA_ENABLED)
 #  include <QVideoFrame>
 #endif
 
 namespace {
-    const auto textureUpdateInterval = 5;
-    const auto nonTextureUpdateInterval = 1000;
+    const auto addWatchesInterval = 5;
+    const auto retryWatchesInterval = 1000;
+    const auto evictUnusedFilesInterval = 1000;
 
     void setUtf8Encoding(QTextStream &stream)
     {
@@ -83,11 +91,26 @@ namespace {
         if (!texture || FileDialog::isEmptyOrUntitled(fileName))
             return false;
 
+        auto subimage = 0;
+        const auto path = FileDialog::getSubimageFileName(fileName, &subimage);
         auto file = TextureData();
-        if (!file.load(fileName))
+        if (!file.load(path, subimage))
             return false;
 
-        *texture = file;
+        // by default devices generate the mipmaps, otherwise they are
+        // generated once and cached with the file
+        const auto &settings = Singletons::settings();
+        const auto filter =
+            static_cast<TextureData::MipmapFilter>(settings.mipmapFilter());
+        if (filter == TextureData::MipmapFilter::None) {
+            *texture = std::move(file);
+            return true;
+        }
+        *texture = file.generateMipmaps({
+            .filter = filter,
+            .sRGB = settings.mipmapSRGB(),
+            .preserveAlphaCoverage = settings.mipmapAlphaCoverage(),
+        });
         return true;
     }
 
@@ -108,6 +131,9 @@ class FileCache::BackgroundLoader final : public QObject
 {
     Q_OBJECT
 
+public:
+    explicit BackgroundLoader(FileCache &fileCache) : mFileCache(fileCache) { }
+
 public Q_SLOTS:
     void loadSource(const QString &fileName)
     {
@@ -121,7 +147,7 @@ public Q_SLOTS:
     void loadTexture(const QString &fileName)
     {
         auto texture = TextureData();
-        if (::loadTexture(fileName, &texture))
+        if (mFileCache.openTexture(fileName, &texture))
             Q_EMIT textureLoaded(fileName, std::move(texture));
         else
             Q_EMIT loadingFailed(fileName);
@@ -152,6 +178,8 @@ Q_SIGNALS:
     void loadingFailed(const QString &fileName);
 
 private:
+    FileCache &mFileCache;
+
 #if defined(MULTIMEDIA_ENABLED)
     void convertNextVideoFrame()
     {
@@ -179,18 +207,15 @@ FileCache::FileCache(QObject *parent) : QObject(parent)
 {
     qRegisterMetaType<TextureData>();
 
-    connect(&mFileSystemWatcher, &QFileSystemWatcher::fileChanged, this,
+    connect(&mFileSystemWatcher, &FileSystemWatcher::fileChanged, this,
         &FileCache::handleFileSystemFileChanged);
     connect(&mUpdateFileSystemWatchesTimer, &QTimer::timeout, this,
         &FileCache::updateFileSystemWatches);
+    connect(&mEvictUnusedFilesTimer, &QTimer::timeout, this,
+        &FileCache::evictUnusedFiles);
 
-    auto backgroundLoader = new BackgroundLoader();
-    connect(this, &FileCache::reloadSource, backgroundLoader,
-        &BackgroundLoader::loadSource);
-    connect(this, &FileCache::reloadTexture, backgroundLoader,
-        &BackgroundLoader::loadTexture);
-    connect(this, &FileCache::reloadBinary, backgroundLoader,
-        &BackgroundLoader::loadBinary);
+    auto backgroundLoader = new BackgroundLoader(*this);
+    mBackgroundLoader = backgroundLoader;
     connect(this, &FileCache::convertVideoFrame, backgroundLoader,
         &BackgroundLoader::convertVideoFrame);
 
@@ -209,13 +234,16 @@ FileCache::FileCache(QObject *parent) : QObject(parent)
     mBackgroundLoaderThread.start();
     backgroundLoader->moveToThread(&mBackgroundLoaderThread);
 
-    mUpdateFileSystemWatchesTimer.setInterval(textureUpdateInterval);
+    mUpdateFileSystemWatchesTimer.setInterval(addWatchesInterval);
     mUpdateFileSystemWatchesTimer.setSingleShot(false);
-    mUpdateFileSystemWatchesTimer.start();
+    mEvictUnusedFilesTimer.setInterval(evictUnusedFilesInterval);
+    mEvictUnusedFilesTimer.setSingleShot(true);
 }
 
 FileCache::~FileCache()
 {
+    mReloadThreadPool.clear();
+    mReloadThreadPool.waitForDone();
     mBackgroundLoaderThread.quit();
     mBackgroundLoaderThread.wait();
 }
@@ -225,8 +253,10 @@ void FileCache::unloadAll()
     QMutexLocker lock(&mMutex);
     mSources.clear();
     mTextures.clear();
+    mCompressedTextures.clear();
     mBinaries.clear();
     mFileSystemWatchesToAdd.clear();
+    mLastUsed.clear();
 }
 
 void FileCache::invalidateFile(const QString &fileName)
@@ -257,13 +287,14 @@ void FileCache::handleEditorSave(const QString &fileName)
 
 bool FileCache::updateFromEditor(const QString &fileName)
 {
+    touchFile(fileName);
     auto &editorManager = Singletons::editorManager();
     if (auto editor = editorManager.getSourceEditor(fileName)) {
         mSources[fileName] = editor->source();
         return true;
     }
     if (auto editor = editorManager.getBinaryEditor(fileName)) {
-        mBinaries[fileName] = editor->data();
+        editor->updateData(&mBinaries[fileName]);
         return true;
     }
     if (auto editor = editorManager.getTextureEditor(fileName)) {
@@ -293,16 +324,21 @@ bool FileCache::getSource(const QString &fileName, QString *source) const
     Q_ASSERT(source);
     Q_ASSERT(isNativeCanonicalFilePath(fileName));
     QMutexLocker lock(&mMutex);
+    waitForPrefetch(fileName);
 
     if (mSources.contains(fileName)) {
         *source = mSources[fileName];
+        touchFile(fileName);
+        ++mHits;
         return true;
     }
 
+    ++mMisses;
     addFileSystemWatch(fileName);
     if (!loadSource(fileName, source))
         return false;
     mSources[fileName] = *source;
+    touchFile(fileName);
     return true;
 }
 
@@ -317,12 +353,16 @@ bool FileCache::getTexture(const QString &fileName, QSize requestedResolution,
     Q_ASSERT(texture);
     Q_ASSERT(isNativeCanonicalFilePath(fileName));
     QMutexLocker lock(&mMutex);
+    waitForPrefetch(fileName);
 
     if (mTextures.contains(fileName)) {
         *texture = mTextures[fileName];
+        touchFile(fileName);
+        ++mHits;
         return true;
     }
 
+    ++mMisses;
     addFileSystemWatch(fileName);
 
     if (FileDialog::isMediaFileName(fileName)) {
@@ -330,10 +370,56 @@ bool FileCache::getTexture(const QString &fileName, QSize requestedResolution,
             requestedResolution.width(), requestedResolution.height(), 1, 1);
         texture->clear();
         Q_EMIT mediaRequested(fileName, requestedResolution);
-    } else if (!loadTexture(fileName, texture)) {
+    } else if (!openTexture(fileName, texture)) {
         return false;
     }
     mTextures[fileName] = *texture;
+    touchFile(fileName);
+    return true;
+}
+
+bool FileCache::getCompressedTexture(const QString &fileName,
+    const TextureData &source, Texture::Format format, TextureData *texture,
+    double *psnr) const
+{
+    Q_ASSERT(texture);
+    const auto sourceHash = source.getDataHash();
+    const auto quality = static_cast<TextureData::CompressionQuality>(
+        Singletons::settings().textureCompression());
+
+    QMutexLocker lock(&mMutex);
+    for (const auto &compressed : mCompressedTextures.value(fileName))
+        if (compressed.sourceHash == sourceHash && compressed.format == format
+            && compressed.quality == quality
+            && (!psnr || !std::isnan(compressed.psnr))) {
+            *texture = compressed.texture;
+            if (psnr)
+                *psnr = compressed.psnr;
+            touchFile(fileName);
+            return true;
+        }
+    lock.unlock();
+
+    // compressing can take a while, do not block other files
+    // PSNR requires decompressing, it is only computed when requested
+    auto compressed = CompressedTexture{ sourceHash, format, quality, {},
+        std::numeric_limits<double>::quiet_NaN() };
+    compressed.texture = source.compress(format, quality,
+        (psnr ? &compressed.psnr : nullptr));
+    if (compressed.texture.isNull())
+        return false;
+    *texture = compressed.texture;
+    if (psnr)
+        *psnr = compressed.psnr;
+
+    // only keep the latest source, videos would accumulate frames otherwise
+    lock.relock();
+    auto &compressedTextures = mCompressedTextures[fileName];
+    compressedTextures.removeIf([&](const CompressedTexture &other) {
+        return (other.format == format && other.quality == quality);
+    });
+    compressedTextures.append(std::move(compressed));
+    touchFile(fileName);
     return true;
 }
 
@@ -347,6 +433,7 @@ void FileCache::updateSource(const QString &fileName, QString source)
         editor->replace(std::move(source));
     } else {
         QMutexLocker lock(&mMutex);
+        touchFile(fileName);
         mSources[fileName] = std::move(source);
         lock.unlock();
         Q_EMIT fileChanged(fileName);
@@ -364,6 +451,7 @@ void FileCache::updateTexture(const QString &fileName, TextureData texture)
         editor->replace(std::move(texture));
     } else {
         QMutexLocker lock(&mMutex);
+        touchFile(fileName);
         mTextures[fileName] = std::move(texture);
         lock.unlock();
         Q_EMIT fileChanged(fileName);
@@ -391,13 +479,14 @@ void FileCache::updateBinary(const QString &fileName, QByteArray binary)
         editor->replace(binary);
     } else {
         QMutexLocker lock(&mMutex);
+        touchFile(fileName);
         mBinaries[fileName] = std::move(binary);
         lock.unlock();
         Q_EMIT fileChanged(fileName);
     }
 }
 
-void FileCache::updateBinaryRange(const QString &fileName, int offset,
+void FileCache::updateBinaryRange(const QString &fileName, qsizetype offset,
     const QByteArray &range)
 {
     Q_ASSERT(isNativeCanonicalFilePath(fileName));
@@ -405,12 +494,11 @@ void FileCache::updateBinaryRange(const QString &fileName, int offset,
     if (offset < 0)
         return;
 
+    if (auto editor = Singletons::editorManager().getBinaryEditor(fileName))
+        return editor->replaceRange(offset, range);
+
     auto data = QByteArray();
-    if (auto editor = Singletons::editorManager().getBinaryEditor(fileName)) {
-        data = editor->data();
-    } else {
-        getBinary(fileName, &data);
-    }
+    getBinary(fileName, &data);
     if (offset == 0 && range.size() >= data.size())
         return updateBinary(fileName, range);
 
@@ -430,31 +518,296 @@ bool FileCache::getBinary(const QString &fileName, QByteArray *binary) const
     Q_ASSERT(binary);
     Q_ASSERT(isNativeCanonicalFilePath(fileName));
     QMutexLocker lock(&mMutex);
+    waitForPrefetch(fileName);
 
     if (mBinaries.contains(fileName)) {
         *binary = mBinaries[fileName];
+        touchFile(fileName);
+        ++mHits;
         return true;
     }
 
+    ++mMisses;
     addFileSystemWatch(fileName);
     if (!loadBinary(fileName, binary))
         return false;
     mBinaries[fileName] = *binary;
+    touchFile(fileName);
     return true;
 }
 
+void FileCache::prefetchSource(const QString &fileName,
+    const QString &includePaths)
+{
+    if (!beginPrefetch(fileName))
+        return;
+
+    mReloadThreadPool.start(
+        [this, fileName, includePaths]() {
+            auto source = QString();
+            const auto loaded = loadSource(fileName, &source);
+            endPrefetch(fileName, loaded, [&]() {
+                if (!mSources.contains(fileName))
+                    mSources[fileName] = source;
+            });
+            if (!loaded)
+                return;
+
+            static const auto regex =
+                QRegularExpression(R"(^\s*#include\s*[<"]([^>"\n]+)[>"])",
+                    QRegularExpression::MultilineOption);
+            for (auto it = regex.globalMatch(source); it.hasNext();)
+                prefetchSource(resolveIncludePath(fileName,
+                                   it.next().captured(1), includePaths),
+                    includePaths);
+        },
+        2);
+}
+
+void FileCache::prefetchTexture(const QString &fileName)
+{
+    if (FileDialog::isMediaFileName(fileName)
+        || FileDialog::isSequenceFileName(fileName)
+        || !beginPrefetch(fileName))
+        return;
+
+    mReloadThreadPool.start(
+        [this, fileName]() {
+            auto texture = TextureData();
+            const auto loaded = openTexture(fileName, &texture);
+            endPrefetch(fileName, loaded, [&]() {
+                if (!mTextures.contains(fileName))
+                    mTextures[fileName] = std::move(texture);
+            });
+        },
+        1);
+}
+
+void FileCache::prefetchBinary(const QString &fileName)
+{
+    if (!beginPrefetch(fileName))
+        return;
+
+    mReloadThreadPool.start(
+        [this, fileName]() {
+            auto binary = QByteArray();
+            const auto loaded = loadBinary(fileName, &binary);
+            endPrefetch(fileName, loaded, [&]() {
+                if (!mBinaries.contains(fileName))
+                    mBinaries[fileName] = std::move(binary);
+            });
+        },
+        1);
+}
+
+bool FileCache::beginPrefetch(const QString &fileName)
+{
+    Q_ASSERT(isNativeCanonicalFilePath(fileName));
+    QMutexLocker lock(&mMutex);
+    if (FileDialog::isEmptyOrUntitled(fileName)
+        || mPrefetching.contains(fileName) || mSources.contains(fileName)
+        || mTextures.contains(fileName) || mBinaries.contains(fileName))
+        return false;
+
+    mPrefetching.insert(fileName);
+    return true;
+}
+
+template <typename F>
+void FileCache::endPrefetch(const QString &fileName, bool loaded,
+    F &&storeLoaded)
+{
+    QMutexLocker lock(&mMutex);
+    if (loaded) {
+        storeLoaded();
+        touchFile(fileName);
+        addFileSystemWatch(fileName);
+    }
+    mPrefetching.remove(fileName);
+    mPrefetchFinished.wakeAll();
+}
+
+void FileCache::waitForPrefetch(const QString &fileName) const
+{
+    while (mPrefetching.contains(fileName))
+        mPrefetchFinished.wait(&mMutex);
+}
+
+void FileCache::touchFile(const QString &fileName) const
+{
+    mLastUsed[fileName] = ++mUseCounter;
+    scheduleEviction();
+}
+
+// the budget is checked once files were used, so idle caches are not polled
+void FileCache::scheduleEviction() const
+{
+    if (!std::exchange(mEvictionScheduled, true))
+        QMetaObject::invokeMethod(
+            &mEvictUnusedFilesTimer,
+            [timer = &mEvictUnusedFilesTimer]() { timer->start(); },
+            Qt::QueuedConnection);
+}
+
+void FileCache::handleMemoryBudgetChanged()
+{
+    QMutexLocker lock(&mMutex);
+    scheduleEviction();
+}
+
+qint64 FileCache::getMemoryUsage(const QString &fileName) const
+{
+    auto bytes = qint64{};
+    if (const auto it = mSources.constFind(fileName); it != mSources.cend())
+        bytes += it->size() * static_cast<qint64>(sizeof(QChar));
+    if (const auto it = mTextures.constFind(fileName); it != mTextures.cend())
+        bytes += static_cast<qint64>(it->getLoadedDataSize());
+    if (const auto it = mCompressedTextures.constFind(fileName);
+        it != mCompressedTextures.cend())
+        for (const auto &compressed : *it)
+            bytes += static_cast<qint64>(compressed.texture.getDataSize());
+    if (const auto it = mBinaries.constFind(fileName); it != mBinaries.cend())
+        bytes += it->size();
+    return bytes;
+}
+
+qint64 FileCache::getMemoryBudget() const
+{
+    return qint64{ Singletons::settings().fileCacheBudget() } * 1024 * 1024;
+}
+
+FileCache::Statistics FileCache::statistics() const
+{
+    QMutexLocker lock(&mMutex);
+    auto statistics = Statistics{};
+    statistics.sourceCount = static_cast<int>(mSources.size());
+    statistics.textureCount = static_cast<int>(mTextures.size());
+    statistics.binaryCount = static_cast<int>(mBinaries.size());
+    for (const auto &source : std::as_const(mSources))
+        statistics.sourceBytes +=
+            source.size() * static_cast<qint64>(sizeof(QChar));
+    for (const auto &texture : std::as_const(mTextures)) {
+        const auto loadedBytes = texture.getLoadedDataSize();
+        statistics.textureBytes += static_cast<qint64>(loadedBytes);
+        statistics.textureMappedBytes +=
+            static_cast<qint64>(texture.getDataSize() - loadedBytes);
+    }
+    for (const auto &compressedTextures : std::as_const(mCompressedTextures))
+        for (const auto &compressed : compressedTextures)
+            statistics.textureBytes +=
+                static_cast<qint64>(compressed.texture.getDataSize());
+    for (const auto &binary : std::as_const(mBinaries))
+        statistics.binaryBytes += binary.size();
+    statistics.memoryBudget = getMemoryBudget();
+    statistics.hits = mHits;
+    statistics.misses = mMisses;
+    statistics.evictions = mEvictions;
+    statistics.textureOpenTime = mTextureOpenTime;
+    return statistics;
+}
+
+void FileCache::evictUnusedFiles()
+{
+    Q_ASSERT(onMainThread());
+
+    // files of the current session and of open editors are kept
+    auto referenced = QSet<QString>();
+    Singletons::sessionModel().forEachFileItem(
+        [&](const FileItem &item) { referenced.insert(item.fileName); });
+    auto &editorManager = Singletons::editorManager();
+    for (const auto &fileNames : { editorManager.getSourceFileNames(),
+             editorManager.getBinaryFileNames(),
+             editorManager.getImageFileNames() })
+        for (const auto &fileName : fileNames)
+            referenced.insert(fileName);
+
+    auto evicted = QStringList();
+    {
+        QMutexLocker lock(&mMutex);
+        mEvictionScheduled = false;
+        const auto memoryBudget = getMemoryBudget();
+        if (memoryBudget <= 0)
+            return;
+
+        auto memoryUsage = qint64{};
+        for (auto it = mLastUsed.cbegin(); it != mLastUsed.cend(); ++it)
+            memoryUsage += getMemoryUsage(it.key());
+        if (memoryUsage <= memoryBudget)
+            return;
+
+        auto leastRecentlyUsed = std::vector<std::pair<quint64, QString>>();
+        for (auto it = mLastUsed.cbegin(); it != mLastUsed.cend(); ++it)
+            if (!referenced.contains(it.key()))
+                leastRecentlyUsed.emplace_back(it.value(), it.key());
+        std::sort(leastRecentlyUsed.begin(), leastRecentlyUsed.end());
+
+        for (const auto &[lastUsed, fileName] : leastRecentlyUsed) {
+            if (memoryUsage <= memoryBudget)
+                break;
+            memoryUsage -= getMemoryUsage(fileName);
+            removeFile(fileName);
+            evicted.append(fileName);
+            ++mEvictions;
+        }
+    }
+
+    // media streams wait for their workers when destroyed,
+    // so they are unloaded without holding the lock
+    for (const auto &fileName : std::as_const(evicted))
+        Singletons::mediaManager().unloadFile(fileName);
+}
+
 void FileCache::handleFileSystemFileChanged(const QString &fileName)
 {
     Q_ASSERT(onMainThread());
-    addFileSystemWatch(fileName, true);
+    QMutexLocker lock(&mMutex);
+
+    // changes reported by the watcher are handled immediately
+    mFileSystemWatchesToAdd.remove(fileName);
+    if (!updateFileSystemWatch(fileName, true))
+        addFileSystemWatch(fileName, true);
 }
 
 void FileCache::addFileSystemWatch(const QString &fileName, bool changed) const
 {
     Q_ASSERT(isNativeCanonicalFilePath(fileName));
-    if (!FileDialog::isEmptyOrUntitled(fileName)
-        && !FileDialog::isSequenceFileName(fileName))
-        mFileSystemWatchesToAdd[fileName] |= changed;
+    if (FileDialog::isEmptyOrUntitled(fileName)
+        || (FileDialog::isSequenceFileName(fileName)
+            && !FileSystemWatcher::canWatchSequences()))
+        return;
+
+    // timer is restarted at the short interval for each new watch
+    if (!mFileSystemWatchesToAdd.contains(fileName))
+        QMetaObject::invokeMethod(
+            &mUpdateFileSystemWatchesTimer,
+            [timer = &mUpdateFileSystemWatchesTimer]() {
+                timer->start(addWatchesInterval);
+            },
+            Qt::QueuedConnection);
+    mFileSystemWatchesToAdd[fileName] |= changed;
+}
+
+bool FileCache::updateFileSystemWatch(const QString &fileName, bool changed)
+{
+    if (!mFileSystemWatcher.contains(fileName)) {
+        if (!mFileSystemWatcher.addPath(fileName)) {
+            // inform editor that file does no longer exist
+            if (auto editor = Singletons::editorManager().getEditor(fileName))
+                editor->setModified();
+            return false;
+        }
+    } else if (!FileDialog::isSequenceFileName(fileName)
+        && !QFileInfo::exists(FileDialog::getSubimageFileName(fileName))) {
+        mFileSystemWatcher.removePath(fileName);
+    }
+
+    if (changed && !mEditorSaveAdvertised.remove(fileName)) {
+        if (!reloadFileInBackground(fileName)) {
+            purgeFile(fileName);
+            Q_EMIT fileChanged(fileName);
+        }
+    }
+    return true;
 }
 
 void FileCache::updateFileSystemWatches()
@@ -462,68 +815,97 @@ void FileCache::updateFileSystemWatches()
     Q_ASSERT(onMainThread());
     QMutexLocker lock(&mMutex);
 
-    const auto updatingNonTextures =
-        ((mFileSystemWatcherUpdate++
-             % (nonTextureUpdateInterval / textureUpdateInterval))
-            == 0);
-
     for (auto it = mFileSystemWatchesToAdd.begin();
         it != mFileSystemWatchesToAdd.end();) {
-        const auto &fileName = it.key();
-        const auto &changed = it.value();
-
-        auto deferUpdate = (!updatingNonTextures
-            && (mSources.contains(fileName) || mBinaries.contains(fileName)));
-
-        if (!deferUpdate) {
-            if (!mFileSystemWatcher.files().contains(fileName)) {
-                if (!mFileSystemWatcher.addPath(fileName)) {
-                    deferUpdate = true;
-
-                    // inform editor that file does no longer exist
-                    if (auto editor =
-                            Singletons::editorManager().getEditor(fileName))
-                        editor->setModified();
-                }
-            } else if (!QFileInfo::exists(fileName)) {
-                mFileSystemWatcher.removePath(fileName);
-            }
-        }
-
-        if (!deferUpdate) {
-            if (changed && !mEditorSaveAdvertised.remove(fileName)) {
-                if (!reloadFileInBackground(fileName)) {
-                    purgeFile(fileName);
-                    Q_EMIT fileChanged(fileName);
-                }
-            }
+        if (updateFileSystemWatch(it.key(), it.value())) {
             it = mFileSystemWatchesToAdd.erase(it);
         } else {
             ++it;
         }
     }
+
+    // files which can not be watched yet are polled slowly
+    if (mFileSystemWatchesToAdd.isEmpty()) {
+        mUpdateFileSystemWatchesTimer.stop();
+    } else {
+        mUpdateFileSystemWatchesTimer.setInterval(retryWatchesInterval);
+    }
 }
 
 bool FileCache::reloadFileInBackground(const QString &fileName)
 {
+    // media files are reloaded by MediaManager once purged
+    if (FileDialog::isMediaFileName(fileName))
+        return false;
+
+    // sources are reloaded first, then the files of the current session
+    auto load = &BackgroundLoader::loadSource;
+    auto priority = 0;
     if (mSources.contains(fileName)) {
-        Q_EMIT reloadSource(fileName, QPrivateSignal());
+        priority = 2;
     } else if (mTextures.contains(fileName)) {
-        Q_EMIT reloadTexture(fileName, QPrivateSignal());
+        load = &BackgroundLoader::loadTexture;
     } else if (mBinaries.contains(fileName)) {
-        Q_EMIT reloadBinary(fileName, QPrivateSignal());
+        load = &BackgroundLoader::loadBinary;
     } else {
         return false;
     }
-    mUpdateFileSystemWatchesTimer.stop();
+    if (!priority && Singletons::sessionModel().findFileItem(fileName))
+        priority = 1;
+
+    // coalesce requests while file is still being reloaded
+    if (const auto it = mPendingReloads.find(fileName);
+        it != mPendingReloads.end()) {
+        it.value() = true;
+        return true;
+    }
+    mPendingReloads[fileName] = false;
+
+    mReloadThreadPool.start(
+        [loader = mBackgroundLoader, load, fileName]() {
+            (loader->*load)(fileName);
+        },
+        priority);
     return true;
 }
 
-void FileCache::purgeFile(const QString &fileName)
+void FileCache::handleReloadFinished(const QString &fileName)
+{
+    const auto it = mPendingReloads.find(fileName);
+    if (it == mPendingReloads.end())
+        return;
+
+    const auto reloadAgain = it.value();
+    mPendingReloads.erase(it);
+    if (reloadAgain) {
+        QMutexLocker lock(&mMutex);
+        reloadFileInBackground(fileName);
+    }
+}
+
+// the time spent opening textures is part of the statistics
+bool FileCache::openTexture(const QString &fileName,
+    TextureData *texture) const
+{
+    auto timer = QElapsedTimer();
+    timer.start();
+    const auto loaded = loadTexture(fileName, texture);
+    mTextureOpenTime += timer.elapsed();
+    return loaded;
+}
+
+void FileCache::removeFile(const QString &fileName)
 {
     mSources.remove(fileName);
     mBinaries.remove(fileName);
     mTextures.remove(fileName);
+    mCompressedTextures.remove(fileName);
+    mLastUsed.remove(fileName);
+}
+
+void FileCache::purgeFile(const QString &fileName)
+{
+    removeFile(fileName);
     Singletons::mediaManager().unloadFile(fileName);
 }
 
@@ -531,6 +913,7 @@ void FileCache::handleSourceReloaded(const QString &fileName, QString source)
 {
     Q_ASSERT(onMainThread());
     QMutexLocker lock(&mMutex);
+    touchFile(fileName);
     mSources[fileName] = source;
     lock.unlock();
 
@@ -538,7 +921,7 @@ void FileCache::handleSourceReloaded(const QString &fileName, QString source)
         editor->load();
 
     Q_EMIT fileChanged(fileName);
-    mUpdateFileSystemWatchesTimer.start();
+    handleReloadFinished(fileName);
 }
 
 void FileCache::handleTextureReloaded(const QString &fileName,
@@ -547,6 +930,7 @@ void FileCache::handleTextureReloaded(const QString &fileName,
     Q_ASSERT(onMainThread());
     Q_ASSERT(!texture.isNull());
     QMutexLocker lock(&mMutex);
+    touchFile(fileName);
     mTextures[fileName] = std::move(texture);
     lock.unlock();
 
@@ -554,13 +938,14 @@ void FileCache::handleTextureReloaded(const QString &fileName,
         editor->load();
 
     Q_EMIT fileChanged(fileName);
-    mUpdateFileSystemWatchesTimer.start();
+    handleReloadFinished(fileName);
 }
 
 void FileCache::handleBinaryReloaded(const QString &fileName, QByteArray binary)
 {
     Q_ASSERT(onMainThread());
     QMutexLocker lock(&mMutex);
+    touchFile(fileName);
     mBinaries[fileName] = binary;
     lock.unlock();
 
@@ -568,13 +953,13 @@ void FileCache::handleBinaryReloaded(const QString &fileName, QByteArray binary)
         editor->load();
 
     Q_EMIT fileChanged(fileName);
-    mUpdateFileSystemWatchesTimer.start();
+    handleReloadFinished(fileName);
 }
 
 void FileCache::handleReloadingFailed(const QString &fileName)
 {
     Q_ASSERT(onMainThread());
-    mUpdateFileSystemWatchesTimer.start();
+    handleReloadFinished(fileName);
 }
 
 #include "FileCache.moc"
@@ -1,13 +1,18 @@
 #pragma once
 
+#include "FileSystemWatcher.h"
 #include "TextureData.h"
-#include <QFileSystemWatcher>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
 #include <QSet>
 #include <QThread>
+#include <QThreadPool>
 #include <QTimer>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
 
 class QVideoFrame;
 
@@ -15,6 +20,22 @@ class FileCache final : public QObject
 {
     Q_OBJECT
 public:
+    struct Statistics
+    {
+        int sourceCount;
+        int textureCount;
+        int binaryCount;
+        qint64 sourceBytes;
+        qint64 textureBytes;
+        qint64 binaryBytes;
+        qint64 memoryBudget;
+        qint64 hits;
+        qint64 misses;
+        qint64 evictions;
+        qint64 textureMappedBytes;
+        qint64 textureOpenTime;
+    };
+
     explicit FileCache(QObject *parent = nullptr);
     ~FileCache();
 
@@ -23,13 +44,17 @@ public:
     bool getTexture(const QString &fileName, QSize requestedResolution,
         TextureData *texture) const;
     bool getBinary(const QString &fileName, QByteArray *binary) const;
+    // block compresses source of file, results are cached per quality
+    bool getCompressedTexture(const QString &fileName,
+        const TextureData &source, Texture::Format format,
+        TextureData *texture, double *psnr) const;
 
     void updateSource(const QString &fileName, QString source);
     void updateTexture(const QString &fileName, TextureData texture);
     void updateVideoTexture(const QString &fileName, const QVideoFrame &frame);
     void updateVideoTexture(const QString &fileName, TextureData texture);
     void updateBinary(const QString &fileName, QByteArray binary);
-    void updateBinaryRange(const QString &fileName, int offset,
+    void updateBinaryRange(const QString &fileName, qsizetype offset,
         const QByteArray &range);
 
     // only call from main thread
@@ -39,14 +64,19 @@ public:
         bool emitFileChanged = true);
     void handleEditorSave(const QString &fileName);
     void updateFromEditors();
+    void handleMemoryBudgetChanged();
+    Statistics statistics() const;
+
+    // load in background, getters wait until file was loaded
+    void prefetchSource(const QString &fileName,
+        const QString &includePaths = {});
+    void prefetchTexture(const QString &fileName);
+    void prefetchBinary(const QString &fileName);
 
 Q_SIGNALS:
     void fileChanged(const QString &fileName);
     void mediaRequested(const QString &fileName,
         QSize requestedResolution) const;
-    void reloadSource(const QString &fileName, QPrivateSignal);
-    void reloadTexture(const QString &fileName, QPrivateSignal);
-    void reloadBinary(const QString &fileName, QPrivateSignal);
     void convertVideoFrame(const QString &fileName, const QVideoFrame &frame,
         QPrivateSignal);
 
@@ -59,24 +89,59 @@ public Q_SLOTS:
 private:
     class BackgroundLoader;
 
+    struct CompressedTexture
+    {
+        size_t sourceHash;
+        Texture::Format format;
+        TextureData::CompressionQuality quality;
+        TextureData texture;
+        double psnr;
+    };
+
     void handleFileSystemFileChanged(const QString &fileName);
     void addFileSystemWatch(const QString &fileName,
         bool changed = false) const;
+    bool updateFileSystemWatch(const QString &fileName, bool changed);
     void updateFileSystemWatches();
     bool reloadFileInBackground(const QString &fileName);
+    void handleReloadFinished(const QString &fileName);
     bool updateFromEditor(const QString &fileName);
+    void removeFile(const QString &fileName);
     void purgeFile(const QString &fileName);
+    bool openTexture(const QString &fileName, TextureData *texture) const;
+    bool beginPrefetch(const QString &fileName);
+    template <typename F>
+    void endPrefetch(const QString &fileName, bool loaded, F &&storeLoaded);
+    void waitForPrefetch(const QString &fileName) const;
+    void touchFile(const QString &fileName) const;
+    void scheduleEviction() const;
+    qint64 getMemoryUsage(const QString &fileName) const;
+    qint64 getMemoryBudget() const;
+    void evictUnusedFiles();
 
     mutable QMutex mMutex;
     mutable QMap<QString, QString> mSources;
     mutable QMap<QString, TextureData> mTextures;
+    mutable QMap<QString, QList<CompressedTexture>> mCompressedTextures;
     mutable QMap<QString, QByteArray> mBinaries;
     mutable QMap<QString, bool> mFileSystemWatchesToAdd;
+    QSet<QString> mPrefetching;
+    mutable QWaitCondition mPrefetchFinished;
+    mutable QHash<QString, quint64> mLastUsed;
+    mutable quint64 mUseCounter{};
+    mutable qint64 mHits{};
+    mutable qint64 mMisses{};
+    qint64 mEvictions{};
+    mutable std::atomic<qint64> mTextureOpenTime{};
 
     QSet<QString> mEditorFilesChanged;
     QSet<QString> mEditorSaveAdvertised;
-    QTimer mUpdateFileSystemWatchesTimer;
-    QFileSystemWatcher mFileSystemWatcher;
-    int mFileSystemWatcherUpdate{ };
+    mutable QTimer mUpdateFileSystemWatchesTimer;
+    mutable QTimer mEvictUnusedFilesTimer;
+    mutable bool mEvictionScheduled{};
+    FileSystemWatcher mFileSystemWatcher;
     QThread mBackgroundLoaderThread;
+    BackgroundLoader *mBackgroundLoader{};
+    QThreadPool mReloadThreadPool;
+    QMap<QString, bool> mPendingReloads;
 };
@@ -128,7 +128,7 @@ QString FileDialog::getFileExtension(const QString &fileName)
         return "";
     if (isUntitled(fileName))
         return getFileExtension(getFileTitle(fileName));
-    return QFileInfo(fileName).suffix().toLower();
+    return QFileInfo(getSubimageFileName(fileName)).suffix().toLower();
 }
 
 bool FileDialog::isSessionFileName(const QString &fileName)
@@ -196,6 +196,18 @@ bool FileDialog::isSequenceFileName(const QString &fileName)
     return (QFileInfo(fileName).fileName().contains(imageSequencePattern));
 }
 
+// a suffix like "#2" selects a subimage of a multi-part file
+QString FileDialog::getSubimageFileName(const QString &fileName,
+    int *subimage)
+{
+    static const auto subimagePattern = QRegularExpression("#(\\d+)$");
+    const auto match = subimagePattern.match(fileName);
+    const auto hasSubimage = (match.hasMatch() && !QFileInfo::exists(fileName));
+    if (subimage)
+        *subimage = (hasSubimage ? match.captured(1).toInt() : 0);
+    return (hasSubimage ? fileName.left(match.capturedStart()) : fileName);
+}
+
 bool FileDialog::isMediaFileName(const QString &fileName)
 {
     return isVideoFileName(fileName) || isSequenceFileName(fileName)
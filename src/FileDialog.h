@@ -23,6 +23,8 @@ public:
     static bool isScriptFileName(const QString &fileName);
     static bool isTextureFileName(const QString &fileName);
     static bool isSequenceFileName(const QString &fileName);
+    static QString getSubimageFileName(const QString &fileName,
+        int *subimage = nullptr);
     static bool isVideoFileName(const QString &fileName);
     static bool isAudioFileName(const QString &fileName);
     static bool isCameraFileName(const QString &fileName);
@@ -0,0 +1,222 @@
+#include "FileSystemWatcher.h"
+#include "FileDialog.h"
+#include <QFileInfo>
+
+#if defined(__linux__)
+#  include <QSocketNotifier>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+    const auto coalesceInterval = 20;
+} // namespace
+
+FileSystemWatcher::FileSystemWatcher(QObject *parent) : QObject(parent)
+{
+    mCoalesceTimer.setSingleShot(true);
+    mCoalesceTimer.setInterval(coalesceInterval);
+    connect(&mCoalesceTimer, &QTimer::timeout, this,
+        &FileSystemWatcher::emitFilesChanged);
+
+#if defined(__linux__)
+    mInotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (mInotify >= 0) {
+        mNotifier = new QSocketNotifier(mInotify, QSocketNotifier::Read, this);
+        connect(mNotifier, &QSocketNotifier::activated, this,
+            &FileSystemWatcher::readEvents);
+    }
+#else
+    connect(&mWatcher, &QFileSystemWatcher::fileChanged, this,
+        &FileSystemWatcher::handleFileChanged);
+#endif
+}
+
+FileSystemWatcher::~FileSystemWatcher()
+{
+#if defined(__linux__)
+    if (mInotify >= 0)
+        ::close(mInotify);
+#endif
+}
+
+void FileSystemWatcher::handleFileChanged(const QString &fileName)
+{
+    // notify once the burst of events of a save is over
+    mChangedFiles.insert(fileName);
+    mCoalesceTimer.start();
+}
+
+void FileSystemWatcher::emitFilesChanged()
+{
+    for (const auto &fileName : std::exchange(mChangedFiles, {}))
+        Q_EMIT fileChanged(fileName);
+}
+
+#if defined(__linux__)
+
+bool FileSystemWatcher::canWatchSequences()
+{
+    return true;
+}
+
+bool FileSystemWatcher::addPath(const QString &fileName)
+{
+    if (mInotify < 0 || contains(fileName))
+        return false;
+
+    // sequences and subimages are watched by pattern, other files need
+    // to exist
+    const auto fileInfo = QFileInfo(fileName);
+    const auto subimageFileName = FileDialog::getSubimageFileName(fileName);
+    const auto subimageFileInfo = QFileInfo(subimageFileName);
+    auto sequencePattern = QRegularExpression();
+    if (subimageFileName != fileName) {
+        if (!subimageFileInfo.isFile())
+            return false;
+        sequencePattern = QRegularExpression("^"
+            + QRegularExpression::escape(subimageFileInfo.fileName()) + "$");
+    } else if (FileDialog::isSequenceFileName(fileName)) {
+        static const auto placeholder = QRegularExpression("%\\d+d");
+        const auto name = fileInfo.fileName();
+        const auto match = placeholder.match(name);
+        sequencePattern = QRegularExpression("^"
+            + QRegularExpression::escape(name.left(match.capturedStart()))
+            + "\\d+"
+            + QRegularExpression::escape(name.mid(match.capturedEnd()))
+            + "$");
+    } else if (!fileInfo.isFile()) {
+        return false;
+    }
+
+    const auto path = fileInfo.absolutePath();
+    auto it = mDirectories.find(path);
+    if (it == mDirectories.end()) {
+        const auto descriptor = inotify_add_watch(mInotify,
+            QFile::encodeName(path).constData(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE
+                | IN_ONLYDIR);
+        if (descriptor < 0)
+            return false;
+        it = mDirectories.insert(path, Directory{ descriptor, {} });
+        mDirectoryByDescriptor[descriptor] = path;
+    }
+    it->files[fileInfo.fileName()] = { fileName, sequencePattern,
+        subimageFileInfo.lastModified() };
+    return true;
+}
+
+bool FileSystemWatcher::removePath(const QString &fileName)
+{
+    const auto fileInfo = QFileInfo(fileName);
+    const auto it = mDirectories.find(fileInfo.absolutePath());
+    if (it == mDirectories.end() || !it->files.remove(fileInfo.fileName()))
+        return false;
+
+    if (it->files.isEmpty()) {
+        inotify_rm_watch(mInotify, it->descriptor);
+        mDirectoryByDescriptor.remove(it->descriptor);
+        mDirectories.erase(it);
+    }
+    return true;
+}
+
+bool FileSystemWatcher::contains(const QString &fileName) const
+{
+    const auto fileInfo = QFileInfo(fileName);
+    const auto it = mDirectories.find(fileInfo.absolutePath());
+    return (it != mDirectories.end()
+        && it->files.contains(fileInfo.fileName()));
+}
+
+void FileSystemWatcher::readEvents()
+{
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+        const auto size = ::read(mInotify, buffer, sizeof(buffer));
+        if (size <= 0)
+            break;
+
+        for (auto offset = ssize_t{}; offset < size;) {
+            const auto event =
+                reinterpret_cast<const inotify_event *>(buffer + offset);
+            if (event->mask & IN_Q_OVERFLOW)
+                rescanDirectories();
+            else
+                handleEvent(event->wd,
+                    (event->len ? QFile::decodeName(event->name) : QString()),
+                    (event->mask & IN_IGNORED));
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+}
+
+void FileSystemWatcher::handleEvent(int descriptor, const QString &name,
+    bool ignored)
+{
+    const auto path = mDirectoryByDescriptor.value(descriptor);
+    const auto it = mDirectories.find(path);
+    if (it == mDirectories.end())
+        return;
+
+    if (ignored) {
+        // directory was removed, report all files
+        for (const auto &file : std::as_const(it->files))
+            handleFileChanged(file.fileName);
+        mDirectoryByDescriptor.remove(descriptor);
+        mDirectories.erase(it);
+        return;
+    }
+
+    for (auto file = it->files.begin(); file != it->files.end(); ++file)
+        if (file.key() == name
+            || (!file->sequencePattern.pattern().isEmpty()
+                && file->sequencePattern.match(name).hasMatch())) {
+            file->lastModified =
+                QFileInfo(FileDialog::getSubimageFileName(file->fileName))
+                    .lastModified();
+            handleFileChanged(file->fileName);
+        }
+}
+
+// events were dropped, report the files which changed since they were
+// last reported and all sequences, which can not be compared
+void FileSystemWatcher::rescanDirectories()
+{
+    for (auto &directory : mDirectories)
+        for (auto &file : directory.files) {
+            if (!FileDialog::isSequenceFileName(file.fileName)) {
+                const auto lastModified =
+                    QFileInfo(FileDialog::getSubimageFileName(file.fileName))
+                        .lastModified();
+                if (lastModified == file.lastModified)
+                    continue;
+                file.lastModified = lastModified;
+            }
+            handleFileChanged(file.fileName);
+        }
+}
+
+#else // !defined(__linux__)
+
+bool FileSystemWatcher::canWatchSequences()
+{
+    return false;
+}
+
+bool FileSystemWatcher::addPath(const QString &fileName)
+{
+    return mWatcher.addPath(fileName);
+}
+
+bool FileSystemWatcher::removePath(const QString &fileName)
+{
+    return mWatcher.removePath(fileName);
+}
+
+bool FileSystemWatcher::contains(const QString &fileName) const
+{
+    return mWatcher.files().contains(fileName);
+}
+
+#endif // !defined(__linux__)
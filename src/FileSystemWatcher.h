@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QDateTime>
+#include <QMap>
+#include <QObject>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTimer>
+
+#if !defined(__linux__)
+#  include <QFileSystemWatcher>
+#endif
+
+class QSocketNotifier;
+
+// watches files by watching their directories, so atomic saves are noticed
+// and image sequences can be watched by pattern, changes are coalesced
+class FileSystemWatcher final : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FileSystemWatcher(QObject *parent = nullptr);
+    ~FileSystemWatcher();
+
+    static bool canWatchSequences();
+    bool addPath(const QString &fileName);
+    bool removePath(const QString &fileName);
+    bool contains(const QString &fileName) const;
+
+Q_SIGNALS:
+    void fileChanged(const QString &fileName);
+
+private:
+    void handleFileChanged(const QString &fileName);
+    void emitFilesChanged();
+
+    QSet<QString> mChangedFiles;
+    QTimer mCoalesceTimer;
+
+#if defined(__linux__)
+    struct WatchedFile
+    {
+        QString fileName;
+        QRegularExpression sequencePattern;
+        QDateTime lastModified;
+    };
+
+    struct Directory
+    {
+        int descriptor;
+        QMap<QString, WatchedFile> files;
+    };
+
+    void readEvents();
+    void handleEvent(int descriptor, const QString &name, bool ignored);
+    void rescanDirectories();
+
+    int mInotify{ -1 };
+    QSocketNotifier *mNotifier{};
+    QMap<QString, Directory> mDirectories;
+    QMap<int, QString> mDirectoryByDescriptor;
+#else
+    QFileSystemWatcher mWatcher;
+#endif
+};
@@ -97,7 +97,10 @@ MessageSeverity getMessageSeverity(const Message &message)
     case ShaderInfo:
     case ScriptMessage:
     case CallDuration:
-    case TotalDuration: return MessageSeverity::Info;
+    case TotalDuration:
+    case SavingFile:
+    case TextureCompressed:
+    case ShaderCompilationsReused: return MessageSeverity::Info;
 
     default: return MessageSeverity::Error;
     }
@@ -140,9 +143,15 @@ QString getMessageText(const Message &message)
             return tr("No file set");
         return tr("Loading file '%1' failed")
             .arg(FileDialog::getFileTitle(message.text));
+    case WritingFileFailed:
+        return tr("Writing file '%1' failed")
+            .arg(FileDialog::getFileTitle(message.text));
+    case SavingFile: return tr("Saving file (%1%)").arg(message.text);
     case ConvertingFileFailed:
         return tr("Converting file '%1' failed")
             .arg(FileDialog::getFileTitle(message.text));
+    case TextureCompressed:
+        return tr("Compressed texture PSNR %1 dB").arg(message.text);
     case UnsupportedShaderType:    return tr("Unsupported shader type");
     case ProgramHasNoShader:       return tr("Program has no shader");
     case UnsupportedTextureFormat: return tr("Unsupported texture format");
@@ -223,8 +232,16 @@ QString getMessageText(const Message &message)
     case RayTracingNotAvailable:     return tr("Raytracing not available");
     case MeshShadersNotAvailable:    return tr("Mesh Shaders not available");
     case ShaderCompilerNotAvailable: return tr("Shader compiler not available");
+    case ShaderCompilationsReused:
+        return tr("%1 shader compilations were reused").arg(message.text);
     case InvalidCommandlineArguments:
         return tr("Invalid argument: %1").arg(message.text);
+    case OutputFileNameCollision:
+        return tr("Output file '%1' is written by another shader")
+            .arg(message.text);
+    case BufferTooLargeForTexture:
+        return tr("Buffer of %1 bytes is too large for a texture")
+            .arg(message.text);
     }
     return message.text;
 #undef tr
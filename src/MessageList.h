@@ -15,7 +15,10 @@ enum class MessageType {
     VulkanNotAvailable,
     Direct3DNotAvailable,
     LoadingFileFailed,
+    WritingFileFailed,
+    SavingFile,
     ConvertingFileFailed,
+    TextureCompressed,
     UnsupportedShaderType,
     ProgramHasNoShader,
     UnsupportedTextureFormat,
@@ -79,7 +82,10 @@ enum class MessageType {
     MeshShadersNotAvailable,
     SpirvCrossError,
     ShaderCompilerNotAvailable,
+    ShaderCompilationsReused,
     InvalidCommandlineArguments,
+    OutputFileNameCollision,
+    BufferTooLargeForTexture,
 };
 
 struct Message
@@ -105,8 +111,11 @@ public:
         QString fileName, int line, bool deduplicate = true);
     static QList<MessagePtr> getAllMessages();
 
+    using QSet::begin;
     using QSet::clear;
+    using QSet::end;
     using QSet::insert;
+    using QSet::isEmpty;
     using QSet::size;
 
     MessagePtrSet &operator+=(const MessagePtr &message)
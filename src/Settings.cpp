@@ -19,6 +19,11 @@ Settings::Settings(QObject *parent)
     setShowWhiteSpace(value("showWhiteSpace", "false").toBool());
     setHideMenuBar(value("hideMenuBar", "false").toBool());
     setSyncInterval(value("syncInterval", "1").toInt());
+    setFileCacheBudget(value("fileCacheBudget", "2048").toInt());
+    setMipmapFilter(value("mipmapFilter", "0").toInt());
+    setMipmapSRGB(value("mipmapSRGB", "false").toBool());
+    setMipmapAlphaCoverage(value("mipmapAlphaCoverage", "false").toBool());
+    setTextureCompression(value("textureCompression", "1").toInt());
 
     const auto fontSettings = value("font").toString();
     auto font = QFont();
@@ -51,6 +56,11 @@ Settings::~Settings()
     setValue("hideMenuBar", hideMenuBar());
     setValue("font", font().toString());
     setValue("syncInterval", syncInterval());
+    setValue("fileCacheBudget", fileCacheBudget());
+    setValue("mipmapFilter", mipmapFilter());
+    setValue("mipmapSRGB", mipmapSRGB());
+    setValue("mipmapAlphaCoverage", mipmapAlphaCoverage());
+    setValue("textureCompression", textureCompression());
     endGroup();
 }
 
@@ -134,3 +144,43 @@ void Settings::setSyncInterval(int syncInterval) {
         Q_EMIT syncIntervalChanged(syncInterval);
     }
 }
+
+void Settings::setFileCacheBudget(int megabytes)
+{
+    if (mFileCacheBudget != megabytes) {
+        mFileCacheBudget = megabytes;
+        Q_EMIT fileCacheBudgetChanged(megabytes);
+    }
+}
+
+void Settings::setMipmapFilter(int filter)
+{
+    if (mMipmapFilter != filter) {
+        mMipmapFilter = filter;
+        Q_EMIT mipmapFilterChanged(filter);
+    }
+}
+
+void Settings::setMipmapSRGB(bool enabled)
+{
+    if (mMipmapSRGB != enabled) {
+        mMipmapSRGB = enabled;
+        Q_EMIT mipmapSRGBChanged(enabled);
+    }
+}
+
+void Settings::setMipmapAlphaCoverage(bool enabled)
+{
+    if (mMipmapAlphaCoverage != enabled) {
+        mMipmapAlphaCoverage = enabled;
+        Q_EMIT mipmapAlphaCoverageChanged(enabled);
+    }
+}
+
+void Settings::setTextureCompression(int quality)
+{
+    if (mTextureCompression != quality) {
+        mTextureCompression = quality;
+        Q_EMIT textureCompressionChanged(quality);
+    }
+}
@@ -31,6 +31,16 @@ public:
     bool hideMenuBar() const { return mHideMenuBar; }
     void setSyncInterval(int syncInterval);
     int syncInterval() const { return mSyncInterval; }
+    void setFileCacheBudget(int megabytes);
+    int fileCacheBudget() const { return mFileCacheBudget; }
+    void setMipmapFilter(int filter);
+    int mipmapFilter() const { return mMipmapFilter; }
+    void setMipmapSRGB(bool enabled);
+    bool mipmapSRGB() const { return mMipmapSRGB; }
+    void setMipmapAlphaCoverage(bool enabled);
+    bool mipmapAlphaCoverage() const { return mMipmapAlphaCoverage; }
+    void setTextureCompression(int quality);
+    int textureCompression() const { return mTextureCompression; }
 
 Q_SIGNALS:
     void tabSizeChanged(int tabSize);
@@ -44,6 +54,11 @@ Q_SIGNALS:
     void editorThemeChanged(const Theme &theme);
     void hideMenuBarChanged(bool hide);
     void syncIntervalChanged(int syncInterval);
+    void fileCacheBudgetChanged(int megabytes);
+    void mipmapFilterChanged(int filter);
+    void mipmapSRGBChanged(bool enabled);
+    void mipmapAlphaCoverageChanged(bool enabled);
+    void textureCompressionChanged(int quality);
 
 private:
     int mTabSize{ 2 };
@@ -55,4 +70,9 @@ private:
     const Theme *mEditorTheme{};
     bool mHideMenuBar{};
     int mSyncInterval{ 1 };
+    int mFileCacheBudget{ 2048 };
+    int mMipmapFilter{ };
+    bool mMipmapSRGB{};
+    bool mMipmapAlphaCoverage{};
+    int mTextureCompression{ 1 };
 };
@@ -211,6 +211,8 @@ Singletons::Singletons(QMainWindow *window)
 
     QObject::connect(&fileCache(), &FileCache::mediaRequested, &mediaManager(),
         &MediaManager::handleMediaRequested, Qt::QueuedConnection);
+    QObject::connect(&settings(), &Settings::fileCacheBudgetChanged,
+        &fileCache(), &FileCache::handleMemoryBudgetChanged);
 
     mDefaultScriptEngine = ScriptEngine::make(QDir::current());
 }
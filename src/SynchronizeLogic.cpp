@@ -91,7 +91,6 @@ SynchronizeLogic::SynchronizeLogic(QObject *parent)
     mUpdateEditorsTimer->start(100);
     mEvaluationTimer->setTimerType(Qt::PreciseTimer);
 
-    mProcessSourceTimer->setInterval(50);
     mProcessSourceTimer->setSingleShot(true);
 }
 
@@ -100,19 +99,19 @@ SynchronizeLogic::~SynchronizeLogic() = default;
 void SynchronizeLogic::setValidateSource(bool validate)
 {
     if (std::exchange(mValidateSource, validate) != validate)
-        mProcessSourceTimer->start();
+        triggerProcessSource();
 }
 
 void SynchronizeLogic::setProcessSourceType(QString type)
 {
     if (std::exchange(mProcessSourceType, type) != type)
-        mProcessSourceTimer->start();
+        triggerProcessSource();
 }
 
 void SynchronizeLogic::setCurrentEditorFileName(QString fileName)
 {
     if (std::exchange(mCurrentEditorFileName, fileName) != fileName) {
-        mProcessSourceTimer->start();
+        triggerProcessSource();
 
         Q_EMIT currentEditorChanged(fileName);
     }
@@ -121,7 +120,7 @@ void SynchronizeLogic::setCurrentEditorFileName(QString fileName)
 void SynchronizeLogic::setCurrentEditorSourceType(SourceType sourceType)
 {
     if (std::exchange(mCurrentEditorSourceType, sourceType) != sourceType)
-        mProcessSourceTimer->start();
+        triggerProcessSource();
 }
 
 bool SynchronizeLogic::initializeRenderSession()
@@ -145,6 +144,8 @@ bool SynchronizeLogic::initializeRenderSession()
         &SynchronizeLogic::handleEvaluated);
     connect(mProcessSource.get(), &ProcessSource::outputChanged, this,
         &SynchronizeLogic::outputChanged);
+    connect(mProcessSource.get(), &ProcessSource::sourceProcessed, this,
+        &SynchronizeLogic::handleSourceProcessed);
     return true;
 }
 
@@ -224,7 +225,7 @@ void SynchronizeLogic::handleFileChanged(const QString &fileName)
 
     auto &editorManager = Singletons::editorManager();
     if (editorManager.currentEditorFileName() == fileName)
-        mProcessSourceTimer->start();
+        triggerProcessSource();
 
     editorManager.resetQmlViewsDependingOn(fileName);
 }
@@ -304,7 +305,7 @@ void SynchronizeLogic::handleItemModified(const QModelIndex &index)
     }
 
     if (castItem<Session>(item)) {
-        mProcessSourceTimer->start();
+        triggerProcessSource();
     }
     Q_EMIT itemModified(&item);
 }
@@ -590,6 +591,18 @@ void SynchronizeLogic::handleBufferDataChanged(ItemId itemId,
     editors.setAutoRaise(true);
 }
 
+void SynchronizeLogic::triggerProcessSource()
+{
+    // discard result of a still running validation
+    if (mProcessSource)
+        mProcessSource->cancel();
+
+    // adapt delay to time it took to process the source the last time
+    const auto durationMs =
+        mProcessSourceDurations.value(mCurrentEditorFileName);
+    mProcessSourceTimer->start(std::clamp(2 * durationMs, 50, 1000));
+}
+
 void SynchronizeLogic::processSource()
 {
     if (!mValidateSource && mProcessSourceType.isEmpty()) {
@@ -614,6 +627,12 @@ void SynchronizeLogic::processSource()
     mProcessSource->update();
 }
 
+void SynchronizeLogic::handleSourceProcessed(const QString &fileName,
+    int durationMs)
+{
+    mProcessSourceDurations[fileName] = durationMs;
+}
+
 void SynchronizeLogic::handleSessionFileNameChanged(const QString &fileName)
 {
     Q_ASSERT(FileDialog::isEmptyOrUntitled(fileName)
@@ -3,6 +3,7 @@
 #include "SourceType.h"
 #include "session/Item.h"
 #include "render/ShareHandle.h"
+#include <QHash>
 #include <QObject>
 #include <QSet>
 
@@ -85,7 +86,9 @@ private:
     void evaluate(EvaluationType evaluationType);
     void handlePreparingEvaluation(bool &itemsChanged, EvaluationType &type);
     void handleEvaluated();
+    void triggerProcessSource();
     void processSource();
+    void handleSourceProcessed(const QString &fileName, int durationMs);
 
     SessionModel &mModel;
 
@@ -102,6 +105,7 @@ private:
     SourceType mCurrentEditorSourceType{};
     QString mProcessSourceType{};
     QTimer *mProcessSourceTimer{};
+    QHash<QString, int> mProcessSourceDurations;
     std::unique_ptr<ProcessSource> mProcessSource;
     std::unique_ptr<RenderSessionBase> mRenderSession;
 };
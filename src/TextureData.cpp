@@ -1,10 +1,23 @@
 #include "TextureData.h"
+#include "parallelFor.h"
 #include "session/Item.h"
 #include <QImageReader>
+#include <QFile>
 #include <QFileInfo>
+#include <QFloat16>
+#include <QHashFunctions>
+#include <QMutex>
+#include <QThread>
 #include <QtEndian>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <map>
+#include <utility>
+#include <vector>
 
 #if defined(OPENIMAGEIO_ENABLED)
 #  if defined(_MSC_VER)
@@ -557,27 +570,28 @@ namespace {
             || sampleType == TextureSampleType::Float);
     }
 
-    template <typename Source, typename Dest, int Shift>
-    void convert(const Source *source, Dest *dest, int pixels,
+    // integers are normalized to their full range like in the conversion
+    // to float, but in double precision, so 32 bit values are exact
+    template <typename Source, typename Dest>
+    void convertInteger(const Source *source, Dest *dest, int pixels,
         int sourceComponents, int destComponents)
     {
+        constexpr auto sourceMax =
+            static_cast<double>(std::numeric_limits<Source>::max());
+        constexpr auto max =
+            static_cast<double>(std::numeric_limits<Dest>::max());
+        constexpr auto min = (std::is_signed_v<Dest> ? -max : 0.0);
+        constexpr auto scale = max / sourceMax;
         for (auto i = 0; i < pixels; ++i) {
             for (auto c = 0; c < destComponents; ++c) {
-                const auto v = (c < sourceComponents ? source[c]
-                        : c < 3 ? Source{ }
-                                : std::numeric_limits<Source>::max());
-                if constexpr (Shift < 0) {
-                    if constexpr (std::is_floating_point_v<Dest>) {
-                        dest[c] = static_cast<Dest>(v) / Dest{ 1ull << -Shift };
-                    } else {
-                        dest[c] = static_cast<Dest>(v >> -Shift);
-                    }
+                if (c >= sourceComponents) {
+                    dest[c] = (c < 3 ? Dest{ }
+                                     : std::numeric_limits<Dest>::max());
+                } else if constexpr (std::is_same_v<Source, Dest>) {
+                    dest[c] = source[c];
                 } else {
-                    if constexpr (std::is_floating_point_v<Dest>) {
-                        dest[c] = static_cast<Dest>(v) * Dest{ 1ull << Shift };
-                    } else {
-                        dest[c] = static_cast<Dest>(v << Shift);
-                    }
+                    const auto v = std::clamp(source[c] * scale, min, max);
+                    dest[c] = static_cast<Dest>(v + std::copysign(0.5, v));
                 }
             }
             source += sourceComponents;
@@ -585,8 +599,77 @@ namespace {
         }
     }
 
+    // plain loops over all values, which compilers can vectorize
+    template <typename T>
+    void convertToFloat(const T *source, float *dest, qsizetype count)
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            std::memcpy(dest, source, count * sizeof(float));
+        } else if constexpr (std::is_same_v<T, qfloat16>) {
+            qFloatFromFloat16(dest, source, count);
+        } else {
+            constexpr auto scale = 1.0f / std::numeric_limits<T>::max();
+            for (auto i = qsizetype{ }; i < count; ++i)
+                dest[i] = std::max(static_cast<float>(source[i]) * scale,
+                    -1.0f);
+        }
+    }
+
+    template <typename T>
+    void convertFromFloat(const float *source, T *dest, qsizetype count)
+    {
+        if constexpr (std::is_same_v<T, float>) {
+            std::memcpy(dest, source, count * sizeof(float));
+        } else if constexpr (std::is_same_v<T, qfloat16>) {
+            qFloatToFloat16(dest, source, count);
+        } else {
+            using F = std::conditional_t<(sizeof(T) < 4), float, double>;
+            constexpr auto max = static_cast<F>(std::numeric_limits<T>::max());
+            constexpr auto min = (std::is_signed_v<T> ? -max : F{ });
+            for (auto i = qsizetype{ }; i < count; ++i) {
+                const auto v = std::clamp(source[i] * max, min, max);
+                dest[i] = static_cast<T>(v + std::copysign(F{ 0.5 }, v));
+            }
+        }
+    }
+
+    void convertComponents(const float *source, int sourceComponents,
+        float *dest, int destComponents, int pixels)
+    {
+        for (auto i = 0; i < pixels; ++i) {
+            for (auto c = 0; c < destComponents; ++c)
+                dest[c] = (c < sourceComponents ? source[c]
+                        : c < 3                ? 0.0f
+                                               : 1.0f);
+            source += sourceComponents;
+            dest += destComponents;
+        }
+    }
+
+    template <typename F>
+    bool withDataType(TextureDataType dataType, const F &function)
+    {
+        using DT = TextureDataType;
+        switch (dataType) {
+        case DT::Int8:    function(int8_t{ }); return true;
+        case DT::Int16:   function(int16_t{ }); return true;
+        case DT::Int32:   function(int32_t{ }); return true;
+        case DT::Uint8:   function(uint8_t{ }); return true;
+        case DT::Uint16:  function(uint16_t{ }); return true;
+        case DT::Uint32:  function(uint32_t{ }); return true;
+        case DT::Float16: function(qfloat16{ }); return true;
+        case DT::Float32: function(float{ }); return true;
+        case DT::Packed:
+        case DT::Compressed: break;
+        }
+        return false;
+    }
+
+    // integers are converted directly, otherwise the row is converted
+    // to float and from float to the destination type
     bool convertRow(const uchar *source, Texture::Format sourceFormat,
-        uchar *dest, Texture::Format destFormat, int pixels)
+        uchar *dest, Texture::Format destFormat, int pixels,
+        std::vector<float> &buffer)
     {
         if (!source || !dest)
             return false;
@@ -596,40 +679,62 @@ namespace {
         const auto sourceComponents = getTextureComponentCount(sourceFormat);
         const auto destComponents = getTextureComponentCount(destFormat);
 
-#define ADD(SOURCE_TYPE, SOURCE, DEST_TYPE, DEST, SHIFT)                       \
-    if (sourceDataType == TextureDataType::SOURCE_TYPE                         \
-        && destDataType == TextureDataType::DEST_TYPE) {                       \
-        convert<SOURCE, DEST, SHIFT>(reinterpret_cast<const SOURCE *>(source), \
-            reinterpret_cast<DEST *>(dest), pixels, sourceComponents,          \
-            destComponents);                                                   \
-        return true;                                                           \
-    }
-        ADD(Uint8, uint8_t, Uint8, uint8_t, 0)
-        ADD(Uint8, uint8_t, Uint16, uint16_t, 8)
-        ADD(Uint8, uint8_t, Uint32, uint32_t, 16)
-        ADD(Uint8, uint8_t, Int8, int8_t, -1)
-        ADD(Uint8, uint8_t, Int16, int16_t, 7)
-        ADD(Uint8, uint8_t, Int32, int32_t, 15)
-
-        ADD(Uint16, uint16_t, Uint8, uint8_t, -8)
-        ADD(Uint16, uint16_t, Uint16, uint16_t, 0)
-        ADD(Uint16, uint16_t, Uint32, uint32_t, 8)
-        ADD(Uint16, uint16_t, Int8, int8_t, -9)
-        ADD(Uint16, uint16_t, Int16, int16_t, -1)
-        ADD(Uint16, uint16_t, Int32, int32_t, 7)
-
-        ADD(Uint32, uint32_t, Uint8, uint8_t, -16)
-        ADD(Uint32, uint32_t, Uint16, uint16_t, -8)
-        ADD(Uint32, uint32_t, Uint32, uint32_t, 0)
-        ADD(Uint32, uint32_t, Int8, int8_t, -17)
-        ADD(Uint32, uint32_t, Int16, int16_t, -9)
-        ADD(Uint32, uint32_t, Int32, int32_t, -1)
-
-        ADD(Uint8, uint8_t, Float32, float, -8)
-        ADD(Uint16, uint16_t, Float32, float, -16)
-        ADD(Uint32, uint32_t, Float32, float, -32)
-#undef ADD
-        return false;
+        auto converted = false;
+        if (!withDataType(sourceDataType, [&](auto sourceType) {
+                withDataType(destDataType, [&](auto destType) {
+                    using Source = decltype(sourceType);
+                    using Dest = decltype(destType);
+                    if constexpr (std::is_integral_v<Source>
+                        && std::is_integral_v<Dest>) {
+                        convertInteger(reinterpret_cast<const Source *>(source),
+                            reinterpret_cast<Dest *>(dest), pixels,
+                            sourceComponents, destComponents);
+                        converted = true;
+                    }
+                });
+            }))
+            return false;
+        if (converted)
+            return true;
+
+        const auto sourceCount = qsizetype{ pixels } * sourceComponents;
+        const auto destCount = qsizetype{ pixels } * destComponents;
+        buffer.resize(sourceCount + destCount);
+        auto values = buffer.data();
+        withDataType(sourceDataType, [&](auto sourceType) {
+            using Source = decltype(sourceType);
+            convertToFloat(reinterpret_cast<const Source *>(source), values,
+                sourceCount);
+        });
+        if (sourceComponents != destComponents) {
+            convertComponents(values, sourceComponents, values + sourceCount,
+                destComponents, pixels);
+            values += sourceCount;
+        }
+        return withDataType(destDataType, [&](auto destType) {
+            using Dest = decltype(destType);
+            convertFromFloat(values, reinterpret_cast<Dest *>(dest),
+                destCount);
+        });
+    }
+
+    // number of rows processed by a single task
+    constexpr auto RowsPerTask = 64;
+
+    // each split writes a range of output rows
+    bool resizeParallel(STBIR_RESIZE &resize)
+    {
+        const auto splits = stbir_build_samplers_with_splits(&resize,
+            std::max(getParallelForThreadPool().maxThreadCount(), 1));
+        if (!splits)
+            return false;
+        auto failed = std::atomic<bool>{ };
+        parallelFor(splits, [&](int split) {
+            if (!stbir_resize_extended_split(&resize, split, 1))
+                failed = true;
+        });
+        stbir_free_samplers(&resize);
+        return !failed;
     }
 
     bool resizePlane(const uchar *source, Texture::Format format, uchar *dest,
@@ -658,14 +763,196 @@ namespace {
         case TextureDataType::Uint8:      dataType = STBIR_TYPE_UINT8_SRGB; break;
         case TextureDataType::Uint16:     dataType = STBIR_TYPE_UINT16; break;
         case TextureDataType::Uint32:     return { };
-        case TextureDataType::Float16:    dataType = STBIR_TYPE_FLOAT; break;
-        case TextureDataType::Float32:    dataType = STBIR_TYPE_HALF_FLOAT; break;
+        case TextureDataType::Float16:    dataType = STBIR_TYPE_HALF_FLOAT; break;
+        case TextureDataType::Float32:    dataType = STBIR_TYPE_FLOAT; break;
+        }
+
+        auto resize = STBIR_RESIZE{ };
+        stbir_resize_init(&resize, source, sourceWidth, sourceHeight,
+            sourceStride, dest, destWidth, destHeight, destStride, pixelLayout,
+            dataType);
+        stbir_set_edgemodes(&resize, STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP);
+        stbir_set_filters(&resize, STBIR_FILTER_DEFAULT, STBIR_FILTER_DEFAULT);
+        return resizeParallel(resize);
+    }
+
+    constexpr auto MipmapFilterRadius = 3.0f;
+    constexpr auto AlphaTestThreshold = 0.5f;
+
+    using FloatSlices = std::vector<std::vector<float>>;
+
+    float sinc(float x)
+    {
+        if (std::abs(x) < 1e-6f)
+            return 1.0f;
+        x *= 3.14159265f;
+        return std::sin(x) / x;
+    }
+
+    // zeroth order modified Bessel function of the first kind
+    float besselI0(float x)
+    {
+        auto sum = 1.0f;
+        auto term = 1.0f;
+        for (auto k = 1; k < 16; ++k) {
+            const auto t = x / static_cast<float>(2 * k);
+            term *= t * t;
+            sum += term;
+        }
+        return sum;
+    }
+
+    // kernels are evaluated in destination pixels by stb_image_resize2
+    float kaiserFilter(float x, float, void *)
+    {
+        constexpr auto alpha = 4.0f;
+        const auto t = x / MipmapFilterRadius;
+        if (std::abs(t) >= 1.0f)
+            return 0.0f;
+        return sinc(x) * besselI0(alpha * std::sqrt(1.0f - t * t))
+            / besselI0(alpha);
+    }
+
+    float lanczosFilter(float x, float, void *)
+    {
+        if (std::abs(x) >= MipmapFilterRadius)
+            return 0.0f;
+        return sinc(x) * sinc(x / MipmapFilterRadius);
+    }
+
+    float mipmapFilterSupport(float, void *)
+    {
+        return MipmapFilterRadius;
+    }
+
+    float linearFromSrgb(float value)
+    {
+        return (value <= 0.04045f ? value / 12.92f
+                                  : std::pow((value + 0.055f) / 1.055f, 2.4f));
+    }
+
+    float srgbFromLinear(float value)
+    {
+        return (value <= 0.0031308f
+                ? value * 12.92f
+                : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f);
+    }
+
+    Texture::Format getFloatFormat(int components)
+    {
+        switch (components) {
+        case 1:  return TF::R32F;
+        case 2:  return TF::RG32F;
+        case 3:  return TF::RGB32F;
+        default: return TF::RGBA32F;
         }
-        const auto filter = STBIR_FILTER_DEFAULT;
-        const auto edgeMode = STBIR_EDGE_CLAMP;
-        return stbir_resize(source, sourceWidth, sourceHeight, sourceStride,
-            dest, destWidth, destHeight, destStride, pixelLayout, dataType,
-            edgeMode, filter);
+    }
+
+    bool downsampleSlice(const std::vector<float> &source, int sourceWidth,
+        int sourceHeight, std::vector<float> &dest, int destWidth,
+        int destHeight, int components, TextureData::MipmapFilter filter)
+    {
+        constexpr stbir_pixel_layout pixelLayouts[] = { STBIR_1CHANNEL,
+            STBIR_2CHANNEL, STBIR_RGB, STBIR_RGBA };
+        dest.resize(static_cast<size_t>(destWidth) * destHeight * components);
+
+        auto resize = STBIR_RESIZE{ };
+        stbir_resize_init(&resize, source.data(), sourceWidth, sourceHeight,
+            0, dest.data(), destWidth, destHeight, 0,
+            pixelLayouts[components - 1], STBIR_TYPE_FLOAT);
+        stbir_set_edgemodes(&resize, STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP);
+        switch (filter) {
+        case TextureData::MipmapFilter::None:
+        case TextureData::MipmapFilter::Box:
+            stbir_set_filters(&resize, STBIR_FILTER_BOX, STBIR_FILTER_BOX);
+            break;
+        case TextureData::MipmapFilter::Kaiser:
+            stbir_set_filter_callbacks(&resize, kaiserFilter,
+                mipmapFilterSupport, kaiserFilter, mipmapFilterSupport);
+            break;
+        case TextureData::MipmapFilter::Lanczos:
+            stbir_set_filter_callbacks(&resize, lanczosFilter,
+                mipmapFilterSupport, lanczosFilter, mipmapFilterSupport);
+            break;
+        }
+        return resizeParallel(resize);
+    }
+
+    float getAlphaCoverage(const FloatSlices &slices, float scale)
+    {
+        auto covered = size_t{ };
+        auto count = size_t{ };
+        for (const auto &slice : slices)
+            for (auto i = size_t{ 3 }; i < slice.size(); i += 4, ++count)
+                if (slice[i] * scale >= AlphaTestThreshold)
+                    ++covered;
+        return (count ? static_cast<float>(covered) / count : 0.0f);
+    }
+
+    // searches the alpha scale, which restores the coverage of the first
+    // level, as described in "Computing Alpha Mipmaps" by Ignacio Castano
+    float getAlphaCoverageScale(const FloatSlices &slices, float coverage)
+    {
+        auto min = 0.0f;
+        auto max = 4.0f;
+        auto scale = 1.0f;
+        for (auto i = 0; i < 10; ++i) {
+            if (getAlphaCoverage(slices, scale) < coverage) {
+                min = scale;
+            } else {
+                max = scale;
+            }
+            scale = (min + max) / 2;
+        }
+        return scale;
+    }
+
+    bool writeOrientation(ktxTexture *texture,
+        TextureData::RowOrder rowOrder)
+    {
+        using RowOrder = TextureData::RowOrder;
+        texture->orientation.y = (rowOrder == RowOrder::BottomToTop
+                ? KTX_ORIENT_Y_UP
+                : KTX_ORIENT_Y_DOWN);
+
+        ktxHashList_DeleteKVPair(&texture->kvDataHead, KTX_ORIENTATION_KEY);
+
+        auto orientation = std::array<char, 16>{ };
+        auto orientationSize = 0u;
+        if (texture->classId == ktxTexture1_c) {
+            switch (texture->numDimensions) {
+            case 1:
+                orientationSize = static_cast<unsigned int>(
+                    std::snprintf(orientation.data(), orientation.size(),
+                        KTX_ORIENTATION1_FMT, texture->orientation.x));
+                break;
+            case 2:
+                orientationSize = static_cast<unsigned int>(
+                    std::snprintf(orientation.data(), orientation.size(),
+                        KTX_ORIENTATION2_FMT, texture->orientation.x,
+                        texture->orientation.y));
+                break;
+            case 3:
+                orientationSize = static_cast<unsigned int>(
+                    std::snprintf(orientation.data(), orientation.size(),
+                        KTX_ORIENTATION3_FMT, texture->orientation.x,
+                        texture->orientation.y, texture->orientation.z));
+                break;
+            default: return false;
+            }
+        } else {
+            orientation[0] = static_cast<char>(texture->orientation.x);
+            if (texture->numDimensions >= 2)
+                orientation[1] = static_cast<char>(texture->orientation.y);
+            if (texture->numDimensions >= 3)
+                orientation[2] = static_cast<char>(texture->orientation.z);
+            orientationSize = texture->numDimensions;
+        }
+
+        return (ktxHashList_AddKVPair(&texture->kvDataHead,
+                    KTX_ORIENTATION_KEY, orientationSize + 1,
+                    orientation.data())
+            == KTX_SUCCESS);
     }
 
     QImage flipImage(QImage &&image)
@@ -677,8 +964,136 @@ namespace {
 #endif
         return image;
     }
+
+    // files below are read completely on load
+    constexpr auto LazyLoadMinimumSize = qint64{ 64 } * 1024 * 1024;
+
+    // rows of files can be packed tighter than rows in memory
+    void copyImageRows(uchar *dest, size_t destSize, const uchar *source,
+        size_t sourceSize, size_t rows)
+    {
+        if (destSize == sourceSize || !rows) {
+            std::memcpy(dest, source, std::min(destSize, sourceSize));
+            return;
+        }
+        const auto destPitch = destSize / rows;
+        const auto sourcePitch = sourceSize / rows;
+        for (auto row = size_t{}; row < rows; ++row)
+            std::memcpy(dest + row * destPitch, source + row * sourcePitch,
+                std::min(destPitch, sourcePitch));
+    }
+
+#if defined(OPENIMAGEIO_ENABLED)
+    // range of rows of a subimage's mip level
+    struct OpenImageIOBand
+    {
+        const OIIO::ImageSpec *spec;
+        int subimage;
+        int miplevel;
+        int row;
+        int rows;
+        uchar *dest;
+        size_t stride;
+        size_t sliceSize;
+    };
+
+    bool readOpenImageIOBand(OIIO::ImageInput &input,
+        const OpenImageIOBand &band)
+    {
+        const auto &spec = *band.spec;
+        const auto ybegin = spec.y + band.row;
+        const auto yend = ybegin + band.rows;
+        if (spec.tile_width > 0)
+            return input.read_tiles(band.subimage, band.miplevel, spec.x,
+                spec.x + spec.width, ybegin, yend, spec.z,
+                spec.z + spec.depth, 0, spec.nchannels, spec.format,
+                band.dest, OIIO::AutoStride,
+                static_cast<OIIO::stride_t>(band.stride),
+                static_cast<OIIO::stride_t>(band.sliceSize));
+
+        for (auto z = 0; z < spec.depth; ++z)
+            if (!input.read_scanlines(band.subimage, band.miplevel, ybegin,
+                    yend, spec.z + z, 0, spec.nchannels, spec.format,
+                    band.dest + z * band.sliceSize, OIIO::AutoStride,
+                    static_cast<OIIO::stride_t>(band.stride)))
+                return false;
+        return true;
+    }
+#endif // OPENIMAGEIO_ENABLED
 } // namespace
 
+// layers are copied from the mapped file on first access of one of their
+// images, copies of a texture share the state
+class TextureData::LazyLayers
+{
+public:
+    LazyLayers(std::shared_ptr<QFile> file, std::vector<FileImage> images,
+        int layerCount)
+        : mFile(std::move(file))
+        , mFileSize(mFile->size())
+        , mFileModified(QFileInfo(*mFile).lastModified())
+        , mImages(std::move(images))
+        , mLoaded(std::make_unique<std::atomic<bool>[]>(layerCount))
+        , mLayerCount(layerCount)
+    {
+    }
+
+    // copyImages returns the number of bytes it filled, it is passed no
+    // images once the file changed
+    template <typename F>
+    void load(int layerIndex, const F &copyImages)
+    {
+        if (mLoaded[layerIndex].load(std::memory_order_acquire))
+            return;
+        QMutexLocker lock(&mMutex);
+        if (mLoaded[layerIndex].load(std::memory_order_relaxed))
+            return;
+
+        // accessing a mapping of a file truncated in place faults, layers
+        // of a changed file are zeroed until the file is reloaded
+        if (mFile && !fileUnchanged())
+            releaseFile();
+        mLoadedSize += copyImages(mImages);
+        mLoaded[layerIndex].store(true, std::memory_order_release);
+
+        // the mapping is no longer needed once all layers were copied
+        if (++mLoadedCount == mLayerCount)
+            releaseFile();
+    }
+
+    size_t loadedSize() const { return mLoadedSize; }
+
+    bool isMapping(const QString &fileName)
+    {
+        QMutexLocker lock(&mMutex);
+        return (mFile && QFileInfo(*mFile) == QFileInfo(fileName));
+    }
+
+private:
+    bool fileUnchanged() const
+    {
+        const auto info = QFileInfo(mFile->fileName());
+        return (info.size() == mFileSize
+            && info.lastModified() == mFileModified);
+    }
+
+    void releaseFile()
+    {
+        mImages.clear();
+        mFile.reset();
+    }
+
+    std::shared_ptr<QFile> mFile;
+    const qint64 mFileSize;
+    const QDateTime mFileModified;
+    std::vector<FileImage> mImages;
+    const std::unique_ptr<std::atomic<bool>[]> mLoaded;
+    const int mLayerCount;
+    int mLoadedCount{ };
+    std::atomic<size_t> mLoadedSize{ };
+    QMutex mMutex;
+};
+
 bool isMultisampleTarget(Texture::Target target)
 {
     return (target == TT::Target2DMultisample
@@ -921,20 +1336,7 @@ bool operator==(const TextureData &a, const TextureData &b)
     if (a.isSharedWith(b))
         return true;
 
-    for (auto level = 0; level < a.levels(); ++level)
-        for (auto layer = 0; layer < a.layers(); ++layer)
-            for (auto face = 0; face < a.faces(); ++face) {
-                const auto da = a.getData(level, layer, face);
-                const auto db = b.getData(level, layer, face);
-                if (da == db)
-                    continue;
-                const auto sa = a.getImageSize(level);
-                const auto sb = b.getImageSize(level);
-                if (sa != sb
-                    || std::memcmp(da, db, static_cast<size_t>(sa)) != 0)
-                    return false;
-            }
-    return true;
+    return (a.getDataHash() == b.getDataHash());
 }
 
 bool TextureData::isSharedWith(const TextureData &other) const
@@ -942,6 +1344,22 @@ bool TextureData::isSharedWith(const TextureData &other) const
     return (mKtxTexture == other.mKtxTexture);
 }
 
+// cached until the data is written, so that comparing a downloaded
+// texture with the previous one only needs to hash the new data
+size_t TextureData::getDataHash() const
+{
+    if (!mDataHash) {
+        auto hash = size_t{ };
+        for (auto level = 0; level < levels(); ++level)
+            for (auto layer = 0; layer < layers(); ++layer)
+                for (auto face = 0; face < faces(); ++face)
+                    hash = qHashBits(getData(level, layer, face),
+                        getImageSize(level), hash);
+        mDataHash = hash;
+    }
+    return *mDataHash;
+}
+
 bool operator!=(const TextureData &a, const TextureData &b)
 {
     return !(a == b);
@@ -1011,6 +1429,8 @@ bool TextureData::create(Texture::Target target, Texture::Format format,
         fixFormat(*texture);
         mKtxTexture.reset(ktxTexture(texture),
             [](ktxTexture *tex) { ktxTexture_Destroy(tex); });
+        mLazyLayers.reset();
+        mDataHash.reset();
         mRowOrder = RowOrder::TopToBottom;
         return true;
     }
@@ -1028,26 +1448,56 @@ TextureData TextureData::convert(Texture::Format destFormat) const
             layers(), levels()))
         return { };
 
-    // only write first level, it will trigger the mipmap generation
-    const auto level = 0;
-    const auto levelWidth = getLevelWidth(level);
-    const auto levelHeight = getLevelHeight(level);
-    const auto sourceStride = getLevelStride(level);
-    const auto destStride = copy.getLevelStride(level);
-    for (auto layer = 0; layer < layers(); ++layer) {
-        for (auto faceSlice = 0; faceSlice < depth() * faces(); ++faceSlice) {
-            const auto *source = getData(level, layer, faceSlice);
-            auto *dest = copy.getWriteonlyData(level, layer, faceSlice);
-            if (!source || !dest)
-                return { };
-
-            for (auto row = 0; row < levelHeight; ++row)
-                if (!convertRow(source + sourceStride * row, sourceFormat,
-                        dest + row * destStride, destFormat, levelWidth))
+    // convert all levels when they were generated, otherwise only write
+    // the first level, it will trigger the mipmap generation
+    struct Image
+    {
+        const uchar *source;
+        uchar *dest;
+        size_t sourceStride;
+        size_t destStride;
+        int width;
+        int height;
+    };
+    const auto levelCount = (mKtxTexture->generateMipmaps ? 1 : levels());
+    auto images = std::vector<Image>();
+    auto chunks = std::vector<std::pair<size_t, int>>();
+    for (auto level = 0; level < levelCount; ++level) {
+        const auto levelWidth = getLevelWidth(level);
+        const auto levelHeight = getLevelHeight(level);
+        for (auto layer = 0; layer < layers(); ++layer) {
+            for (auto faceSlice = 0; faceSlice < getLevelDepth(level) * faces();
+                 ++faceSlice) {
+                const auto *source = getData(level, layer, faceSlice);
+                auto *dest = copy.getWriteonlyData(level, layer, faceSlice);
+                if (!source || !dest)
                     return { };
+                for (auto row = 0; row < levelHeight; row += RowsPerTask)
+                    chunks.emplace_back(images.size(), row);
+                images.push_back({ source, dest, getLevelStride(level),
+                    copy.getLevelStride(level), levelWidth, levelHeight });
+            }
         }
     }
+
+    // rows are converted independently, so splitting does not change them
+    auto failed = std::atomic<bool>{ };
+    parallelFor(static_cast<int>(chunks.size()), [&](int index) {
+        const auto [imageIndex, begin] = chunks[index];
+        const auto &image = images[imageIndex];
+        const auto end = std::min(begin + RowsPerTask, image.height);
+        auto buffer = std::vector<float>();
+        for (auto row = begin; row < end && !failed; ++row)
+            if (!convertRow(image.source + image.sourceStride * row,
+                    sourceFormat, image.dest + image.destStride * row,
+                    destFormat, image.width, buffer))
+                failed = true;
+    });
+    if (failed)
+        return { };
+
     copy.setRowOrder(rowOrder());
+    copy.mKtxTexture->generateMipmaps = mKtxTexture->generateMipmaps;
     return copy;
 }
 
@@ -1064,14 +1514,22 @@ TextureData TextureData::resize(int width, int height, int depth,
             (levels() == 1 ? 1 : 0)))
         return { };
 
+    // stb_image_resize2 only accepts int strides
     const auto level = 0;
+    constexpr auto maxStride =
+        static_cast<size_t>(std::numeric_limits<int>::max());
+    if (getLevelStride(level) > maxStride
+        || copy.getLevelStride(level) > maxStride)
+        return { };
+
     for (auto layer = 0; layer < layers; ++layer)
         for (auto faceSlice = 0; faceSlice < depth * faces(); ++faceSlice)
             if (!resizePlane(getData(level, layer, faceSlice), this->format(),
                     copy.getWriteonlyData(level, layer, faceSlice),
                     getLevelWidth(level), getLevelHeight(level),
-                    getLevelStride(level), copy.getLevelWidth(level),
-                    copy.getLevelHeight(level), copy.getLevelStride(level)))
+                    static_cast<int>(getLevelStride(level)),
+                    copy.getLevelWidth(level), copy.getLevelHeight(level),
+                    static_cast<int>(copy.getLevelStride(level))))
                 return { };
 
     copy.setRowOrder(rowOrder());
@@ -1088,24 +1546,186 @@ TextureData TextureData::reoriented(RowOrder rowOrder) const
             layers(), levels()))
         return { };
 
+    struct Image
+    {
+        const uchar *source;
+        uchar *dest;
+        size_t stride;
+        int height;
+    };
+    auto images = std::vector<Image>();
+    auto chunks = std::vector<std::pair<size_t, int>>();
     for (auto level = 0; level < levels(); ++level) {
         const auto stride = getLevelStride(level);
         const auto levelHeight = getLevelHeight(level);
-        const auto *source = getData(level, 0, 0);
-        auto *dest = copy.getWriteonlyData(level, 0, 0);
-        if (!source || !dest)
-            return { };
-
-        for (auto y = 0; y < levelHeight; ++y)
-            std::memcpy(dest + y * stride,
-                source + (levelHeight - y - 1) * stride,
-                static_cast<size_t>(stride));
+        for (auto layer = 0; layer < layers(); ++layer) {
+            for (auto faceSlice = 0; faceSlice < getLevelDepth(level) * faces();
+                 ++faceSlice) {
+                const auto *source = getData(level, layer, faceSlice);
+                auto *dest = copy.getWriteonlyData(level, layer, faceSlice);
+                if (!source || !dest)
+                    return { };
+                for (auto row = 0; row < levelHeight; row += RowsPerTask)
+                    chunks.emplace_back(images.size(), row);
+                images.push_back({ source, dest, stride, levelHeight });
+            }
+        }
     }
+
+    parallelFor(static_cast<int>(chunks.size()), [&](int index) {
+        const auto [imageIndex, begin] = chunks[index];
+        const auto &image = images[imageIndex];
+        const auto end = std::min(begin + RowsPerTask, image.height);
+        for (auto y = begin; y < end; ++y)
+            std::memcpy(image.dest + y * image.stride,
+                image.source + (image.height - y - 1) * image.stride,
+                image.stride);
+    });
     copy.setRowOrder(rowOrder);
     copy.mKtxTexture->generateMipmaps = mKtxTexture->generateMipmaps;
     return copy;
 }
 
+TextureData TextureData::generateMipmaps(const MipmapOptions &options) const
+{
+    const auto format = this->format();
+    const auto dataType = getTextureDataType(format);
+    const auto sampleType = getTextureSampleType(format);
+    if (isNull() || levels() <= 1 || !mKtxTexture->generateMipmaps
+        || options.filter == MipmapFilter::None
+        || !canGenerateMipmaps(getTarget(), format)
+        || dataType == TextureDataType::Packed
+        || dataType == TextureDataType::Compressed)
+        return *this;
+
+    auto copy = TextureData{ };
+    if (!copy.create(getTarget(), format, width(), height(), depth(),
+            layers(), levels()))
+        return *this;
+
+    const auto *source = getData(0, 0, 0);
+    auto *dest = copy.getWriteonlyData(0, 0, 0);
+    if (!source || !dest)
+        return *this;
+    std::memcpy(dest, source, getLevelSize(0));
+
+    // levels are filtered in float, slices of 3D textures are filtered
+    // in 2D and pairs of them are averaged
+    const auto components = getTextureComponentCount(format);
+    const auto floatFormat = getFloatFormat(components);
+    const auto colorComponents = std::min(components, 3);
+    const auto linearize = (sampleType == TextureSampleType::Normalized_sRGB
+        || (options.sRGB && sampleType == TextureSampleType::Normalized
+            && dataType == TextureDataType::Uint8));
+    const auto preserveAlphaCoverage =
+        (options.preserveAlphaCoverage && components == 4);
+
+    const auto readSlice = [&](int layer, int faceSlice,
+                               std::vector<float> &slice,
+                               std::vector<float> &buffer) {
+        const auto levelWidth = width();
+        const auto stride = getLevelStride(0);
+        const auto *data = getData(0, layer, faceSlice);
+        slice.resize(static_cast<size_t>(levelWidth) * height() * components);
+        for (auto y = 0; y < height(); ++y) {
+            auto *row = slice.data() + static_cast<size_t>(y) * levelWidth
+                * components;
+            if (!convertRow(data + stride * y, format,
+                    reinterpret_cast<uchar *>(row), floatFormat, levelWidth,
+                    buffer))
+                return false;
+        }
+        if (linearize)
+            for (auto i = size_t{ }; i < slice.size(); i += components)
+                for (auto c = 0; c < colorComponents; ++c)
+                    slice[i + c] = linearFromSrgb(slice[i + c]);
+        return true;
+    };
+
+    const auto writeSlice = [&](int level, int layer, int faceSlice,
+                                std::vector<float> slice, float alphaScale,
+                                std::vector<float> &buffer) {
+        for (auto i = size_t{ }; i < slice.size(); i += components) {
+            if (linearize)
+                for (auto c = 0; c < colorComponents; ++c)
+                    slice[i + c] = srgbFromLinear(slice[i + c]);
+            if (preserveAlphaCoverage)
+                slice[i + 3] = std::min(slice[i + 3] * alphaScale, 1.0f);
+        }
+        const auto levelWidth = getLevelWidth(level);
+        const auto stride = copy.getLevelStride(level);
+        auto *data = const_cast<uchar *>(
+            std::as_const(copy).getData(level, layer, faceSlice));
+        for (auto y = 0; y < getLevelHeight(level); ++y) {
+            const auto *row = slice.data() + static_cast<size_t>(y)
+                * levelWidth * components;
+            if (!convertRow(reinterpret_cast<const uchar *>(row), floatFormat,
+                    data + stride * y, format, levelWidth, buffer))
+                return false;
+        }
+        return true;
+    };
+
+    // the levels of each layer and face depend on each other, the slices
+    // are split across threads when they are resized
+    auto failed = std::atomic<bool>{ };
+    parallelFor(layers() * faces(), [&](int index) {
+        const auto layer = index / faces();
+        const auto face = index % faces();
+        auto buffer = std::vector<float>();
+        auto slices = FloatSlices(depth());
+        for (auto z = 0; z < depth(); ++z)
+            if (!readSlice(layer, z * faces() + face, slices[z], buffer)) {
+                failed = true;
+                return;
+            }
+
+        const auto coverage =
+            (preserveAlphaCoverage ? getAlphaCoverage(slices, 1.0f) : 0.0f);
+        for (auto level = 1; level < levels() && !failed; ++level) {
+            const auto prevWidth = getLevelWidth(level - 1);
+            const auto prevHeight = getLevelHeight(level - 1);
+            const auto levelWidth = getLevelWidth(level);
+            const auto levelHeight = getLevelHeight(level);
+            auto next = FloatSlices(getLevelDepth(level));
+            auto other = std::vector<float>();
+            for (auto z = size_t{ }; z < next.size(); ++z) {
+                if (!downsampleSlice(slices[z * 2], prevWidth, prevHeight,
+                        next[z], levelWidth, levelHeight, components,
+                        options.filter)) {
+                    failed = true;
+                    return;
+                }
+                if (z * 2 + 1 < slices.size()) {
+                    if (!downsampleSlice(slices[z * 2 + 1], prevWidth,
+                            prevHeight, other, levelWidth, levelHeight,
+                            components, options.filter)) {
+                        failed = true;
+                        return;
+                    }
+                    for (auto i = size_t{ }; i < other.size(); ++i)
+                        next[z][i] = (next[z][i] + other[i]) / 2;
+                }
+            }
+
+            const auto alphaScale = (preserveAlphaCoverage
+                    ? getAlphaCoverageScale(next, coverage)
+                    : 1.0f);
+            for (auto z = 0; z < static_cast<int>(next.size()); ++z)
+                if (!writeSlice(level, layer, z * faces() + face, next[z],
+                        alphaScale, buffer))
+                    failed = true;
+            slices = std::move(next);
+        }
+    });
+    if (failed)
+        return *this;
+
+    copy.setRowOrder(rowOrder());
+    copy.mKtxTexture->generateMipmaps = KTX_FALSE;
+    return copy;
+}
+
 TextureData TextureData::convert(Texture::Format format, int width, int height,
     int depth, int layers, RowOrder rowOrder) const
 {
@@ -1122,6 +1742,9 @@ bool TextureData::loadKtx(const QString &fileName)
         && !fileName.endsWith(".ktx", Qt::CaseInsensitive))
         return false;
 
+    if (loadKtxLazily(fileName))
+        return true;
+
     auto f = std::fopen(qUtf8Printable(fileName), "rb");
     if (!f)
         return false;
@@ -1152,6 +1775,8 @@ bool TextureData::loadKtx(const QString &fileName)
         return false;
 
     mKtxTexture = std::move(texture);
+    mLazyLayers.reset();
+    mDataHash.reset();
     mRowOrder = (mKtxTexture->orientation.y == KTX_ORIENT_Y_UP
             ? RowOrder::BottomToTop
             : RowOrder::TopToBottom);
@@ -1159,19 +1784,131 @@ bool TextureData::loadKtx(const QString &fileName)
     return true;
 }
 
-bool TextureData::loadOpenImageIO(const QString &fileName)
+// on Windows a mapping would prevent the file from being replaced
+const uchar *TextureData::mapLargeFile(const QString &fileName,
+    std::shared_ptr<QFile> *file)
+{
+#if !defined(_WIN32)
+    auto mappedFile = std::make_shared<QFile>(fileName);
+    if (!mappedFile->open(QFile::ReadOnly)
+        || mappedFile->size() < LazyLoadMinimumSize)
+        return nullptr;
+
+    const auto data = mappedFile->map(0, mappedFile->size());
+    if (data)
+        *file = std::move(mappedFile);
+    return data;
+#else
+    Q_UNUSED(fileName);
+    Q_UNUSED(file);
+    return nullptr;
+#endif
+}
+
+// only uncompressed and not supercompressed files are loaded lazily
+bool TextureData::loadKtxLazily(const QString &fileName)
+{
+    auto file = std::shared_ptr<QFile>();
+    const auto fileData = mapLargeFile(fileName, &file);
+    if (!fileData)
+        return false;
+    const auto fileSize = static_cast<size_t>(file->size());
+
+    auto texturePtr = std::add_pointer_t<ktxTexture>{ };
+    if (ktxTexture_CreateFromMemory(fileData, fileSize,
+            KTX_TEXTURE_CREATE_NO_FLAGS, &texturePtr)
+        != KTX_SUCCESS)
+        return false;
+
+    auto header = TextureData();
+    header.mKtxTexture.reset(texturePtr,
+        [](ktxTexture *tex) { ktxTexture_Destroy(tex); });
+    if (header.format() == TF::NoFormat
+        || ktxTexture_NeedsTranscoding(texturePtr))
+        return false;
+
+    // KTX1 stores the size before each level, KTX2 has a level index
+    const auto isKtx2 = (texturePtr->classId == ktxTexture2_c);
+    const auto levelCount = header.levels();
+    auto levelOffsets = std::vector<size_t>();
+    if (isKtx2) {
+        const auto levelIndexOffset = size_t{ 80 };
+        if (asTexture2(texturePtr)->supercompressionScheme != KTX_SS_NONE
+            || fileSize < levelIndexOffset + levelCount * 24)
+            return false;
+        for (auto level = 0; level < levelCount; ++level)
+            levelOffsets.push_back(static_cast<size_t>(
+                qFromLittleEndian<quint64>(
+                    fileData + levelIndexOffset + level * 24)));
+    } else {
+        // images of other endianness would have to be swapped
+        const auto endianness = size_t{ 12 };
+        const auto bytesOfKeyValueData = size_t{ 60 };
+        if (qFromLittleEndian<quint32>(fileData + endianness) != 0x04030201)
+            return false;
+        const auto dataOffset = 64
+            + qFromLittleEndian<quint32>(fileData + bytesOfKeyValueData);
+        for (auto level = 0; level < levelCount; ++level) {
+            auto offset = ktx_size_t{ };
+            ktxTexture_GetImageOffset(texturePtr,
+                static_cast<ktx_uint32_t>(level), 0, 0, &offset);
+            levelOffsets.push_back(dataOffset + 4 * (level + 1) + offset);
+        }
+    }
+
+    if (!create(header.getTarget(), header.format(), header.width(),
+            header.height(), header.depth(), header.layers(), levelCount))
+        return false;
+
+    auto images = std::vector<FileImage>();
+    for (auto level = 0; level < levelCount; ++level) {
+        auto levelOffset = ktx_size_t{ };
+        ktxTexture_GetImageOffset(texturePtr,
+            static_cast<ktx_uint32_t>(level), 0, 0, &levelOffset);
+        const auto imageSize = header.getImageSize(level);
+        const auto rows = static_cast<size_t>(getLevelHeight(level));
+        for (auto layer = 0; layer < layers(); ++layer)
+            for (auto faceSlice = 0;
+                 faceSlice < getLevelDepth(level) * faces(); ++faceSlice) {
+                auto offset = ktx_size_t{ };
+                ktxTexture_GetImageOffset(texturePtr,
+                    static_cast<ktx_uint32_t>(level),
+                    static_cast<ktx_uint32_t>(layer),
+                    static_cast<ktx_uint32_t>(faceSlice), &offset);
+                offset += levelOffsets[level] - levelOffset;
+                if (offset + imageSize > fileSize) {
+                    *this = {};
+                    return false;
+                }
+                images.push_back({ fileData + offset, imageSize,
+                    isCompressed() ? 1 : rows });
+            }
+    }
+
+    setLazyLayers(std::move(file), std::move(images));
+    mKtxTexture->generateMipmaps = texturePtr->generateMipmaps;
+    mRowOrder = (texturePtr->orientation.y == KTX_ORIENT_Y_UP
+            ? RowOrder::BottomToTop
+            : RowOrder::TopToBottom);
+    return true;
+}
+
+bool TextureData::loadOpenImageIO(const QString &fileName, int subimage)
 {
 #if !defined(OPENIMAGEIO_ENABLED)
     return false;
 #else // OPENIMAGEIO_ENABLED
     using namespace OIIO;
-    auto input = ImageInput::open(qUtf8Printable(fileName));
-    if (!input) {
+    const auto path = fileName.toStdString();
+    auto input = ImageInput::open(path);
+    if (!input || !input->seek_subimage(subimage, 0)) {
         OIIO::geterror();
         return false;
     }
     using F = Texture::Format;
-    const ImageSpec &spec = input->spec();
+    const auto spec = input->spec();
+    if (spec.deep)
+        return false;
 
     const auto channel = [&](auto c1, auto c2, auto c3, auto c4) {
         switch (spec.nchannels) {
@@ -1210,18 +1947,77 @@ bool TextureData::loadOpenImageIO(const QString &fileName)
         }
         return F::NoFormat;
     }();
-    const auto target = (spec.depth > 1 ? TT::Target3D : TT::Target2D);
-    if (!create(target, format, spec.width, spec.height, spec.depth, 1))
-        return false;
 
-    const auto stride = getLevelStride(0);
+    // mip levels of the chain are read directly, without reading the
+    // other parts of the file. further subimages, like parts of a
+    // multi-part file, are not turned into layers but can be selected
+    const auto matches = [&](int level) {
+        if (!input->seek_subimage(subimage, level))
+            return false;
+        const auto &other = input->spec();
+        return (!other.deep && other.nchannels == spec.nchannels
+            && other.format == spec.format
+            && other.width == std::max(spec.width >> level, 1)
+            && other.height == std::max(spec.height >> level, 1)
+            && other.depth == std::max(spec.depth >> level, 1));
+    };
+    auto specs = std::vector<ImageSpec>();
+    while (matches(static_cast<int>(specs.size())))
+        specs.push_back(input->spec());
+    const auto levels = static_cast<int>(specs.size());
 
-    // TODO: load all layers/levels
-    if (!input->read_image(0, 0, 0, -1, spec.format, getWriteonlyData(0, 0, 0),
-            OIIO::AutoStride, stride))
+    const auto target = (spec.depth > 1 ? TT::Target3D : TT::Target2D);
+    if (!create(target, format, spec.width, spec.height, spec.depth, 1,
+            levels > 1 ? levels : 0))
         return false;
 
-    return true;
+    // bands start at tiles or at scanline blocks
+    auto bands = std::vector<OpenImageIOBand>();
+    for (auto level = 0; level < levels; ++level) {
+        const auto &levelSpec = specs[level];
+        const auto bandRows = (levelSpec.tile_height > 0
+                ? (RowsPerTask + levelSpec.tile_height - 1)
+                    / levelSpec.tile_height * levelSpec.tile_height
+                : RowsPerTask);
+        auto *dest = getWriteonlyData(level, 0, 0);
+        if (!dest)
+            return false;
+        for (auto row = 0; row < levelSpec.height; row += bandRows)
+            bands.push_back({ &levelSpec, subimage, level, row,
+                std::min(bandRows, levelSpec.height - row),
+                dest + getLevelStride(level) * row, getLevelStride(level),
+                getImageSize(level) });
+    }
+
+    // each thread decodes with its own input, which is opened on its
+    // first band. the calling thread reuses the input already open
+    const auto callingThread = QThread::currentThread();
+    auto inputsMutex = QMutex();
+    auto inputs = std::map<QThread *, std::unique_ptr<ImageInput>>();
+    inputs[callingThread] = std::move(input);
+    const auto getInput = [&]() -> ImageInput * {
+        QMutexLocker lock(&inputsMutex);
+        auto &threadInput = inputs[QThread::currentThread()];
+        if (!threadInput) {
+            threadInput = ImageInput::open(path);
+            if (!threadInput)
+                return nullptr;
+            threadInput->threads(1);
+        }
+        return threadInput.get();
+    };
+    if (bands.size() > 1)
+        inputs[callingThread]->threads(1);
+
+    auto failed = std::atomic<bool>{ };
+    parallelFor(static_cast<int>(bands.size()), [&](int index) {
+        if (failed)
+            return;
+        auto *reader = getInput();
+        if (!reader || !readOpenImageIOBand(*reader, bands[index]))
+            failed = true;
+    });
+    return !failed;
 #endif // OPENIMAGEIO_ENABLED
 }
 
@@ -1247,11 +2043,11 @@ bool TextureData::loadQImage(QImage image)
             image.height(), 1, 1))
         return false;
 
-    if (static_cast<int>(image.sizeInBytes()) != getImageSize(0))
+    if (static_cast<size_t>(image.sizeInBytes()) != getImageSize(0))
         return false;
 
     auto *dest = getWriteonlyData(0, 0, 0);
-    std::memcpy(dest, image.constBits(), static_cast<size_t>(getImageSize(0)));
+    std::memcpy(dest, image.constBits(), getImageSize(0));
     return true;
 }
 
@@ -1292,13 +2088,13 @@ bool TextureData::loadPfm(const QString &fileName)
     const auto format = (channels == 3 ? TF::RGB32F : TF::R32F);
     if (!create(TT::Target2D, format, width, height, 1, 1))
         return false;
-    const auto size = static_cast<size_t>(getImageSize(0));
+    const auto size = getImageSize(0);
     const auto data = getWriteonlyData(0, 0, 0);
 
     if (endianness == QSysInfo::ByteOrder) {
         read = std::fread(data, 1, size, f);
     } else {
-        auto buffer = QByteArray(getImageSize(0), 0);
+        auto buffer = QByteArray(static_cast<qsizetype>(size), 0);
         read = std::fread(buffer.data(), 1, size, f);
         if (endianness == QSysInfo::LittleEndian) {
             qFromLittleEndian<float>(buffer.data(), size / 4, data);
@@ -1309,10 +2105,13 @@ bool TextureData::loadPfm(const QString &fileName)
     return (read == size);
 }
 
-bool TextureData::load(const QString &fileName)
+bool TextureData::load(const QString &fileName, int subimage)
 {
+    // only OpenImageIO reads files with multiple subimages
+    if (subimage > 0)
+        return loadOpenImageIO(fileName, subimage);
     return loadKtx(fileName) || loadDDS(fileName) || loadPfm(fileName)
-        || loadOpenImageIO(fileName) || loadQImage(fileName);
+        || loadOpenImageIO(fileName, 0) || loadQImage(fileName);
 }
 
 bool TextureData::saveKtx(const QString &fileName)
@@ -1326,47 +2125,9 @@ bool TextureData::saveKtx(const QString &fileName)
         || (writeKtx1 && mKtxTexture->classId != ktxTexture1_c))
         return false;
 
+    loadAllLayers();
     auto *texture = mKtxTexture.get();
-    texture->orientation.y = (rowOrder() == RowOrder::BottomToTop
-            ? KTX_ORIENT_Y_UP
-            : KTX_ORIENT_Y_DOWN);
-
-    ktxHashList_DeleteKVPair(&texture->kvDataHead, KTX_ORIENTATION_KEY);
-
-    auto orientation = std::array<char, 16>{ };
-    auto orientationSize = 0u;
-    if (texture->classId == ktxTexture1_c) {
-        switch (texture->numDimensions) {
-        case 1:
-            orientationSize = static_cast<unsigned int>(
-                std::snprintf(orientation.data(), orientation.size(),
-                    KTX_ORIENTATION1_FMT, texture->orientation.x));
-            break;
-        case 2:
-            orientationSize = static_cast<unsigned int>(std::snprintf(
-                orientation.data(), orientation.size(), KTX_ORIENTATION2_FMT,
-                texture->orientation.x, texture->orientation.y));
-            break;
-        case 3:
-            orientationSize = static_cast<unsigned int>(
-                std::snprintf(orientation.data(), orientation.size(),
-                    KTX_ORIENTATION3_FMT, texture->orientation.x,
-                    texture->orientation.y, texture->orientation.z));
-            break;
-        default: return false;
-        }
-    } else {
-        orientation[0] = static_cast<char>(texture->orientation.x);
-        if (texture->numDimensions >= 2)
-            orientation[1] = static_cast<char>(texture->orientation.y);
-        if (texture->numDimensions >= 3)
-            orientation[2] = static_cast<char>(texture->orientation.z);
-        orientationSize = texture->numDimensions;
-    }
-
-    if (ktxHashList_AddKVPair(&texture->kvDataHead, KTX_ORIENTATION_KEY,
-            orientationSize + 1, orientation.data())
-        != KTX_SUCCESS)
+    if (!writeOrientation(texture, rowOrder()))
         return false;
 
     if (writeKtx2) {
@@ -1382,6 +2143,72 @@ bool TextureData::saveKtx(const QString &fileName)
         == KTX_SUCCESS);
 }
 
+bool TextureData::saveKtx2(const QString &fileName, const KtxOptions &options,
+    const std::function<void(int)> &progress) const
+{
+    if (isNull() || !fileName.endsWith(".ktx2", Qt::CaseInsensitive))
+        return false;
+    const auto reportProgress = [&](int percent) {
+        if (progress)
+            progress(percent);
+    };
+    reportProgress(0);
+
+    // encode a KTX2 copy, so this texture is not modified
+    auto bytes = std::add_pointer_t<ktx_uint8_t>{ };
+    auto size = ktx_size_t{ };
+    loadAllLayers();
+    auto *source = mKtxTexture.get();
+    if ((source->classId == ktxTexture1_c
+                ? ktxTexture1_WriteKTX2ToMemory(asTexture1(source), &bytes,
+                      &size)
+                : ktxTexture_WriteToMemory(source, &bytes, &size))
+        != KTX_SUCCESS)
+        return false;
+    const auto freeBytes = qScopeGuard([&]() { std::free(bytes); });
+
+    auto texturePtr = std::add_pointer_t<ktxTexture2>{ };
+    if (ktxTexture2_CreateFromMemory(bytes, size,
+            KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texturePtr)
+        != KTX_SUCCESS)
+        return false;
+    const auto texture = std::shared_ptr<ktxTexture>(ktxTexture(texturePtr),
+        [](ktxTexture *tex) { ktxTexture_Destroy(tex); });
+    if (!writeOrientation(texture.get(), rowOrder()))
+        return false;
+    reportProgress(10);
+
+    // Basis Universal supports 8 bit normalized formats
+    if (options.encoding != KtxEncoding::None) {
+        auto params = ktxBasisParams{ };
+        params.structSize = sizeof(params);
+        params.uastc = (options.encoding == KtxEncoding::UASTC ? KTX_TRUE
+                                                               : KTX_FALSE);
+        params.threadCount =
+            static_cast<ktx_uint32_t>(std::max(QThread::idealThreadCount(), 1));
+        params.compressionLevel = KTX_ETC1S_DEFAULT_COMPRESSION_LEVEL;
+        params.qualityLevel = 128;
+        params.uastcFlags = KTX_PACK_UASTC_LEVEL_DEFAULT;
+        if (ktxTexture2_CompressBasisEx(texturePtr, &params) != KTX_SUCCESS)
+            return false;
+    }
+    reportProgress(70);
+
+    // ETC1S is already supercompressed with BasisLZ
+    if (options.zstdLevel > 0 && options.encoding != KtxEncoding::ETC1S)
+        if (ktxTexture2_DeflateZstd(texturePtr,
+                static_cast<ktx_uint32_t>(std::clamp(options.zstdLevel, 1, 22)))
+            != KTX_SUCCESS)
+            return false;
+    reportProgress(90);
+
+    if (ktxTexture_WriteToNamedFile(texture.get(), qUtf8Printable(fileName))
+        != KTX_SUCCESS)
+        return false;
+    reportProgress(100);
+    return true;
+}
+
 bool TextureData::savePfm(const QString &fileName) const
 {
     if (!fileName.endsWith(".pfm", Qt::CaseInsensitive))
@@ -1426,10 +2253,10 @@ bool TextureData::saveOpenImageIO(const QString &fileName) const
     if (!output->open(qUtf8Printable(fileName), spec))
         return false;
     const auto flipRows = (rowOrder() == RowOrder::BottomToTop);
-    const auto stride = getLevelStride(0);
+    const auto stride = static_cast<stride_t>(getLevelStride(0));
     const auto *data = getData(0, 0, 0)
         + (flipRows ? (height() - 1) * stride : 0);
-    const auto yStride = static_cast<stride_t>(flipRows ? -stride : stride);
+    const auto yStride = (flipRows ? -stride : stride);
     if (!output->write_image(typeDesc, data, AutoStride, yStride, AutoStride))
         return false;
     return true;
@@ -1452,6 +2279,10 @@ bool TextureData::saveQImage(const QString &fileName) const
 
 bool TextureData::save(const QString &fileName)
 {
+    // the file written may be the one still mapped, otherwise only
+    // the images written are loaded
+    if (mLazyLayers && mLazyLayers->isMapping(fileName))
+        loadAllLayers();
     return saveKtx(fileName) || saveDDS(fileName) || savePfm(fileName)
         || saveOpenImageIO(fileName) || saveQImage(fileName);
 }
@@ -1479,11 +2310,10 @@ QImage TextureData::toImage() const
         return { };
 
     auto image = QImage(width(), height(), imageFormat);
-    if (static_cast<int>(image.sizeInBytes()) != getImageSize(0))
+    if (static_cast<size_t>(image.sizeInBytes()) != getImageSize(0))
         return { };
 
-    std::memcpy(image.bits(), getData(0, 0, 0),
-        static_cast<size_t>(getImageSize(0)));
+    std::memcpy(image.bits(), getData(0, 0, 0), getImageSize(0));
 
     return image;
 }
@@ -1644,12 +2474,11 @@ int TextureData::getLevelDepth(int level) const
             : std::max(static_cast<int>(mKtxTexture->baseDepth) >> level, 1));
 }
 
-int TextureData::getLevelStride(int level) const
+size_t TextureData::getLevelStride(int level) const
 {
-    return (isNull()
-            ? 0
-            : static_cast<int>(ktxTexture_GetRowPitch(mKtxTexture.get(),
-                  static_cast<ktx_uint32_t>(level))));
+    return (isNull() ? 0
+                     : ktxTexture_GetRowPitch(mKtxTexture.get(),
+                           static_cast<ktx_uint32_t>(level)));
 }
 
 int TextureData::levels() const
@@ -1676,12 +2505,18 @@ uchar *TextureData::getWriteonlyData()
 
 const uchar *TextureData::getData() const
 {
+    loadAllLayers();
     return getData(0, 0, 0);
 }
 
-int TextureData::getDataSize() const
+size_t TextureData::getDataSize() const
 {
-    return static_cast<int>(ktxTexture_GetDataSize(mKtxTexture.get()));
+    return ktxTexture_GetDataSize(mKtxTexture.get());
+}
+
+size_t TextureData::getLoadedDataSize() const
+{
+    return (mLazyLayers ? mLazyLayers->loadedSize() : getDataSize());
 }
 
 uchar *TextureData::getWriteonlyData(int level, int layer, int face)
@@ -1693,15 +2528,30 @@ uchar *TextureData::getWriteonlyData(int level, int layer, int face)
         create(getTarget(), format(), width(), height(), depth(), layers(),
             levels());
 
+    // callers may write beyond the image, so lazy loading has to end
+    if (mLazyLayers) {
+        loadAllLayers();
+        mLazyLayers.reset();
+    }
+
+    mDataHash.reset();
+
     // generate mipmaps on next upload when level 0 is written
     mKtxTexture->generateMipmaps =
         (level == 0 && levels() > 1 ? KTX_TRUE : KTX_FALSE);
 
-    return const_cast<uchar *>(
-        static_cast<const TextureData *>(this)->getData(level, layer, face));
+    return getImageData(level, layer, face);
 }
 
 const uchar *TextureData::getData(int level, int layer, int faceSlice) const
+{
+    auto *data = getImageData(level, layer, faceSlice);
+    if (data && mLazyLayers)
+        loadLayer(level, layer);
+    return data;
+}
+
+uchar *TextureData::getImageData(int level, int layer, int faceSlice) const
 {
     if (isNull())
         return nullptr;
@@ -1716,30 +2566,74 @@ const uchar *TextureData::getData(int level, int layer, int faceSlice) const
     return nullptr;
 }
 
+void TextureData::setLazyLayers(std::shared_ptr<QFile> file,
+    std::vector<FileImage> images)
+{
+    mLazyLayers = std::make_shared<LazyLayers>(std::move(file),
+        std::move(images), levels() * layers());
+}
+
+void TextureData::loadLayer(int level, int layer) const
+{
+    // file images are ordered by level, layer and face/slice
+    auto firstImage = size_t{ };
+    for (auto l = 0; l < level; ++l)
+        firstImage += static_cast<size_t>(
+            layers() * getLevelDepth(l) * faces());
+    const auto faceSlices = getLevelDepth(level) * faces();
+    firstImage += static_cast<size_t>(layer * faceSlices);
+
+    mLazyLayers->load(level * layers() + layer,
+        [&](const std::vector<FileImage> &images) {
+            const auto imageSize = getImageSize(level);
+            for (auto faceSlice = 0; faceSlice < faceSlices; ++faceSlice) {
+                auto *dest = getImageData(level, layer, faceSlice);
+                if (images.empty()) {
+                    std::memset(dest, 0x00, imageSize);
+                    continue;
+                }
+                const auto &image = images[firstImage + faceSlice];
+                copyImageRows(dest, imageSize, image.data, image.size,
+                    image.rows);
+            }
+            return imageSize * faceSlices;
+        });
+}
+
+void TextureData::loadAllLayers() const
+{
+    if (!mLazyLayers)
+        return;
+    for (auto level = 0; level < levels(); ++level)
+        for (auto layer = 0; layer < layers(); ++layer)
+            loadLayer(level, layer);
+}
+
 size_t TextureData::getOffset(int level, int layer, int faceSlice) const
 {
-    return std::distance(getData(), getData(level, layer, faceSlice));
+    return std::distance(getImageData(0, 0, 0),
+        getImageData(level, layer, faceSlice));
 }
 
-int TextureData::getImageSize(int level) const
+size_t TextureData::getImageSize(int level) const
 {
     if (isNull())
         return 0;
-    return static_cast<int>(ktxTexture_GetImageSize(mKtxTexture.get(),
-        static_cast<ktx_uint32_t>(level)));
+    return ktxTexture_GetImageSize(mKtxTexture.get(),
+        static_cast<ktx_uint32_t>(level));
 }
 
-int TextureData::getSlicesSize(int level) const
+size_t TextureData::getSlicesSize(int level) const
 {
     return getImageSize(level) * getLevelDepth(level);
 }
 
-int TextureData::getLevelSize(int level) const
+size_t TextureData::getLevelSize(int level) const
 {
     if (isNull())
         return 0;
-    return static_cast<int>(ktxTexture_GetLevelSize(mKtxTexture.get(),
-        static_cast<ktx_uint32_t>(level)));
+    return ktxTexture_GetLevelSize(mKtxTexture.get(),
+        static_cast<ktx_uint32_t>(level));
 }
 
 void TextureData::clear()
@@ -1751,7 +2645,7 @@ void TextureData::clear()
     for (auto layer = 0; layer < layers(); ++layer)
         for (auto face = 0; face < faces(); ++face)
             std::memset(getWriteonlyData(level, layer, face), 0x00,
-                static_cast<size_t>(getImageSize(level)));
+                getImageSize(level));
 }
 
 #if defined(OPENGL_ENABLED)
@@ -1760,6 +2654,7 @@ bool TextureData::uploadGL(GLuint *textureId) const
     if (isNull() || !textureId)
         return false;
 
+    loadAllLayers();
     auto error = GLenum{ };
     auto target = static_cast<GLenum>(getTarget());
     const auto result =
@@ -1785,6 +2680,7 @@ bool TextureData::uploadVK(ktxVulkanDeviceInfo *vdi,
     if (isNull() || !vkTexture || !vdi)
         return false;
 
+    loadAllLayers();
     const auto texture = mKtxTexture.get();
     const auto numLevels = texture->numLevels;
     const auto dataSize = texture->dataSize;
@@ -1796,7 +2692,7 @@ bool TextureData::uploadVK(ktxVulkanDeviceInfo *vdi,
     // KTX's Vulkan mipmap path expects only the base level to be present.
     if (texture->generateMipmaps && texture->numLevels > 1) {
         texture->numLevels = 1;
-        texture->dataSize = static_cast<ktx_size_t>(getLevelSize(0));
+        texture->dataSize = getLevelSize(0);
     }
 
     const auto result = ktxTexture_VkUploadEx(texture, vdi, vkTexture,
@@ -4,7 +4,10 @@
 #include <ktx.h>
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #if defined(OPENGL_ENABLED)
 #  include <qopengl.h>
@@ -15,6 +18,8 @@
 #  include <ktxvulkan.h>
 #endif
 
+class QFile;
+
 class TextureData
 {
 public:
@@ -23,17 +28,59 @@ public:
         BottomToTop,
     };
 
+    enum class MipmapFilter {
+        None,
+        Box,
+        Kaiser,
+        Lanczos,
+    };
+
+    struct MipmapOptions
+    {
+        MipmapFilter filter;
+        // treat 8 bit UNorm colors as sRGB, sRGB formats are always
+        // filtered in linear space
+        bool sRGB;
+        // keep the fraction of pixels passing an alpha test of 0.5
+        bool preserveAlphaCoverage;
+    };
+
+    enum class KtxEncoding {
+        None,
+        UASTC,
+        ETC1S,
+    };
+
+    struct KtxOptions
+    {
+        KtxEncoding encoding;
+        // Zstandard supercompression level 1 to 22, 0 disables it
+        int zstdLevel;
+    };
+
+    enum class CompressionQuality {
+        Fast,
+        Normal,
+        High,
+    };
+
     bool isSharedWith(const TextureData &other) const;
+    size_t getDataHash() const;
     bool create(Texture::Target target, Texture::Format format, int width,
         int height, int depth, int layers, int levels = 0);
     TextureData resize(int width, int height, int depth, int layers) const;
     TextureData reoriented(RowOrder rowOrder) const;
+    TextureData generateMipmaps(const MipmapOptions &options) const;
     TextureData convert(Texture::Format format) const;
     TextureData convert(Texture::Format format, int width, int height,
         int depth, int layers, RowOrder rowOrder) const;
-    bool load(const QString &fileName);
+    TextureData compress(Texture::Format format, CompressionQuality quality,
+        double *psnr = nullptr) const;
+    bool load(const QString &fileName, int subimage = 0);
     bool loadQImage(QImage image);
     bool save(const QString &fileName);
+    bool saveKtx2(const QString &fileName, const KtxOptions &options,
+        const std::function<void(int)> &progress) const;
     bool isNull() const;
     void clear();
     QImage toImage() const;
@@ -53,7 +100,7 @@ public:
     int getLevelWidth(int level) const;
     int getLevelHeight(int level) const;
     int getLevelDepth(int level) const;
-    int getLevelStride(int level) const;
+    size_t getLevelStride(int level) const;
     int levels() const;
     int layers() const;
     int faces() const;
@@ -61,13 +108,15 @@ public:
     RowOrder rowOrder() const { return mRowOrder; }
     uchar *getWriteonlyData();
     const uchar *getData() const;
-    int getDataSize() const;
+    size_t getDataSize() const;
+    // lazily loaded textures only count the layers which were accessed
+    size_t getLoadedDataSize() const;
     uchar *getWriteonlyData(int level, int layer, int faceSlice);
     const uchar *getData(int level, int layer, int faceSlice) const;
     size_t getOffset(int level, int layer, int faceSlice) const;
-    int getImageSize(int level) const;
-    int getSlicesSize(int level) const;
-    int getLevelSize(int level) const;
+    size_t getImageSize(int level) const;
+    size_t getSlicesSize(int level) const;
+    size_t getLevelSize(int level) const;
 
 #if defined(OPENGL_ENABLED)
     bool uploadGL(GLuint *textureId) const;
@@ -83,9 +132,22 @@ public:
     friend bool operator!=(const TextureData &a, const TextureData &b);
 
 private:
+    // image in a mapped file, it is copied on first access of its layer
+    struct FileImage
+    {
+        const uchar *data;
+        size_t size;
+        size_t rows;
+    };
+    class LazyLayers;
+
+    static const uchar *mapLargeFile(const QString &fileName,
+        std::shared_ptr<QFile> *file);
     bool loadKtx(const QString &fileName);
+    bool loadKtxLazily(const QString &fileName);
     bool loadDDS(const QString &fileName);
-    bool loadOpenImageIO(const QString &fileName);
+    bool loadDDSLazily(const QString &fileName);
+    bool loadOpenImageIO(const QString &fileName, int subimage);
     bool loadQImage(const QString &fileName);
     bool loadPfm(const QString &fileName);
     bool saveKtx(const QString &fileName);
@@ -93,8 +155,15 @@ private:
     bool saveQImage(const QString &fileName) const;
     bool saveOpenImageIO(const QString &fileName) const;
     bool savePfm(const QString &fileName) const;
+    void setLazyLayers(std::shared_ptr<QFile> file,
+        std::vector<FileImage> images);
+    void loadLayer(int level, int layer) const;
+    void loadAllLayers() const;
+    uchar *getImageData(int level, int layer, int faceSlice) const;
 
     std::shared_ptr<ktxTexture> mKtxTexture;
+    std::shared_ptr<LazyLayers> mLazyLayers;
+    mutable std::optional<size_t> mDataHash;
     RowOrder mRowOrder{ RowOrder::TopToBottom };
 };
 
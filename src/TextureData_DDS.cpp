@@ -1,12 +1,18 @@
 #include "TextureData.h"
+#include "parallelFor.h"
+#include <QFile>
 
 #if defined(_WIN32) && !defined(NOMINMAX)
 #  define NOMINMAX
 #endif
 #include <DirectXTex.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <limits>
+#include <vector>
 
 using TF = Texture::Format;
 using TT = Texture::Target;
@@ -265,6 +271,77 @@ namespace {
         }
         return true;
     }
+
+    // number of rows compressed by a single task, a multiple of the block size
+    constexpr auto RowsPerBand = 64;
+
+    // uncompressed format the block compressor reads
+    Texture::Format getCompressSourceFormat(Texture::Format format)
+    {
+        switch (format) {
+        case TF::RGB_DXT1:
+        case TF::RGBA_DXT1:
+        case TF::RGBA_DXT3:
+        case TF::RGBA_DXT5:
+        case TF::R_ATI1N_UNorm:
+        case TF::RG_ATI2N_UNorm:
+        case TF::RGB_BP_UNorm:          return TF::RGBA8_UNorm;
+        case TF::R_ATI1N_SNorm:
+        case TF::RG_ATI2N_SNorm:        return TF::RGBA8_SNorm;
+        case TF::RGB_BP_UNSIGNED_FLOAT:
+        case TF::RGB_BP_SIGNED_FLOAT:   return TF::RGBA32F;
+        case TF::SRGB_DXT1:
+        case TF::SRGB_Alpha_DXT1:
+        case TF::SRGB_Alpha_DXT3:
+        case TF::SRGB_Alpha_DXT5:
+        case TF::SRGB_BP_UNorm:         return TF::SRGB8_Alpha8;
+        default:                        return TF::NoFormat;
+        }
+    }
+
+    // channels the compressed format stores
+    int getCompressedComponentCount(Texture::Format format)
+    {
+        switch (format) {
+        case TF::R_ATI1N_UNorm:
+        case TF::R_ATI1N_SNorm:         return 1;
+        case TF::RG_ATI2N_UNorm:
+        case TF::RG_ATI2N_SNorm:        return 2;
+        case TF::RGB_DXT1:
+        case TF::SRGB_DXT1:
+        case TF::RGB_BP_UNSIGNED_FLOAT:
+        case TF::RGB_BP_SIGNED_FLOAT:   return 3;
+        default:                        return 4;
+        }
+    }
+
+    DirectX::TEX_COMPRESS_FLAGS getCompressFlags(
+        TextureData::CompressionQuality quality)
+    {
+        using Quality = TextureData::CompressionQuality;
+        switch (quality) {
+        case Quality::Fast:   return DirectX::TEX_COMPRESS_BC7_QUICK;
+        case Quality::Normal: return DirectX::TEX_COMPRESS_DEFAULT;
+        case Quality::High:
+            return static_cast<DirectX::TEX_COMPRESS_FLAGS>(
+                DirectX::TEX_COMPRESS_BC7_USE_3SUBSETS
+                | DirectX::TEX_COMPRESS_DITHER);
+        }
+        return DirectX::TEX_COMPRESS_DEFAULT;
+    }
+
+    DirectX::Image makeImage(DXGI_FORMAT format, const uchar *pixels,
+        size_t rowPitch, int width, int height)
+    {
+        auto image = DirectX::Image{};
+        image.width = static_cast<size_t>(width);
+        image.height = static_cast<size_t>(height);
+        image.format = format;
+        image.rowPitch = rowPitch;
+        image.slicePitch = rowPitch * image.height;
+        image.pixels = const_cast<uint8_t *>(pixels);
+        return image;
+    }
 } // namespace
 
 bool TextureData::loadDDS(const QString &fileName)
@@ -272,6 +349,9 @@ bool TextureData::loadDDS(const QString &fileName)
     if (!fileName.endsWith(".dds", Qt::CaseInsensitive))
         return false;
 
+    if (loadDDSLazily(fileName))
+        return true;
+
     auto metadata = DirectX::TexMetadata{};
     auto images = DirectX::ScratchImage{};
     const auto path = fileName.toStdWString();
@@ -317,6 +397,91 @@ bool TextureData::loadDDS(const QString &fileName)
     return true;
 }
 
+// only files with a DX10 header are loaded lazily, legacy formats
+// may need to be converted
+bool TextureData::loadDDSLazily(const QString &fileName)
+{
+    auto file = std::shared_ptr<QFile>();
+    const auto fileData = mapLargeFile(fileName, &file);
+    if (!fileData)
+        return false;
+    const auto fileSize = static_cast<size_t>(file->size());
+
+    // magic, DDS_HEADER and DDS_HEADER_DXT10
+    const auto dataOffset = size_t{ 4 + 124 + 20 };
+    const auto fourCCOffset = size_t{ 84 };
+    if (fileSize < dataOffset || std::memcmp(fileData, "DDS ", 4) != 0
+        || std::memcmp(fileData + fourCCOffset, "DX10", 4) != 0)
+        return false;
+
+    auto metadata = DirectX::TexMetadata{};
+    if (FAILED(DirectX::GetMetadataFromDDSMemory(fileData, fileSize,
+            DirectX::DDS_FLAGS_NONE, metadata)))
+        return false;
+
+    const auto format = fromDXGIFormat(metadata);
+    const auto target = getTextureTarget(metadata);
+    if (format == TF::NoFormat || target == static_cast<TT>(0)
+        || !dimensionsFit(metadata)
+        || (metadata.IsCubemap() && metadata.arraySize % 6 != 0))
+        return false;
+
+    // images are stored by array item, level and slice
+    auto rowPitches = std::vector<size_t>();
+    auto slicePitches = std::vector<size_t>();
+    auto levelOffsets = std::vector<size_t>();
+    auto itemSize = size_t{};
+    for (auto level = size_t{}; level < metadata.mipLevels; ++level) {
+        auto rowPitch = size_t{};
+        auto slicePitch = size_t{};
+        if (FAILED(DirectX::ComputePitch(metadata.format,
+                std::max(metadata.width >> level, size_t{ 1 }),
+                std::max(metadata.height >> level, size_t{ 1 }), rowPitch,
+                slicePitch))
+            || !rowPitch)
+            return false;
+        rowPitches.push_back(rowPitch);
+        slicePitches.push_back(slicePitch);
+        levelOffsets.push_back(itemSize);
+        itemSize += slicePitch * std::max(metadata.depth >> level, size_t{ 1 });
+    }
+
+    const auto layers = static_cast<int>(metadata.IsCubemap()
+            ? metadata.arraySize / 6
+            : metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D
+            ? 1
+            : metadata.arraySize);
+    const auto faces = (metadata.IsCubemap() ? 6 : 1);
+    if (!create(target, format, static_cast<int>(metadata.width),
+            static_cast<int>(metadata.height), static_cast<int>(metadata.depth),
+            layers, static_cast<int>(metadata.mipLevels)))
+        return false;
+
+    const auto is3D = (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D);
+    auto images = std::vector<FileImage>();
+    for (auto level = 0; level < levels(); ++level) {
+        const auto slicePitch = slicePitches[level];
+        for (auto layer = 0; layer < layers; ++layer)
+            for (auto faceSlice = 0; faceSlice < getLevelDepth(level) * faces;
+                 ++faceSlice) {
+                const auto item =
+                    static_cast<size_t>(is3D ? 0 : layer * faces + faceSlice);
+                const auto slice = static_cast<size_t>(is3D ? faceSlice : 0);
+                const auto offset = dataOffset + item * itemSize
+                    + levelOffsets[level] + slice * slicePitch;
+                if (offset + slicePitch > fileSize) {
+                    *this = {};
+                    return false;
+                }
+                images.push_back({ fileData + offset, slicePitch,
+                    slicePitch / rowPitches[level] });
+            }
+    }
+
+    setLazyLayers(std::move(file), std::move(images));
+    return true;
+}
+
 bool TextureData::saveDDS(const QString &fileName) const
 {
     if (!fileName.endsWith(".dds", Qt::CaseInsensitive) || isNull())
@@ -381,3 +546,132 @@ bool TextureData::saveDDS(const QString &fileName) const
     return SUCCEEDED(DirectX::SaveToDDSFile(images.GetImages(),
         images.GetImageCount(), metadata, flags, path.c_str()));
 }
+
+TextureData TextureData::compress(Texture::Format format,
+    CompressionQuality quality, double *psnr) const
+{
+    const auto sourceFormat = getCompressSourceFormat(format);
+    if (isNull() || isCompressed() || sourceFormat == TF::NoFormat)
+        return {};
+
+    // levels the device would generate can not be generated from
+    // compressed data, so they are generated before compressing
+    const auto source = convert(sourceFormat).generateMipmaps({
+        .filter = MipmapFilter::Kaiser,
+        .sRGB = false,
+        .preserveAlphaCoverage = false,
+    });
+    if (source.isNull())
+        return {};
+
+    // when they could not be generated only the base level is kept
+    const auto levelCount =
+        (source.mKtxTexture->generateMipmaps ? 1 : levels());
+    auto copy = TextureData();
+    if (!copy.create(getTarget(), format, width(), height(), depth(),
+            layers(), levelCount))
+        return {};
+
+    // bands of rows are compressed independently, they start at block rows
+    struct Band
+    {
+        const uchar *source;
+        uchar *dest;
+        size_t sourceStride;
+        size_t destStride;
+        int width;
+        int height;
+    };
+    auto bands = std::vector<Band>();
+    for (auto level = 0; level < levelCount; ++level) {
+        const auto levelWidth = getLevelWidth(level);
+        const auto levelHeight = getLevelHeight(level);
+        const auto sourceStride = source.getLevelStride(level);
+        const auto blockRows = static_cast<size_t>((levelHeight + 3) / 4);
+        const auto destStride = copy.getImageSize(level) / blockRows;
+        for (auto layer = 0; layer < layers(); ++layer) {
+            for (auto faceSlice = 0; faceSlice < getLevelDepth(level) * faces();
+                 ++faceSlice) {
+                const auto *sourceData =
+                    source.getData(level, layer, faceSlice);
+                auto *destData =
+                    copy.getWriteonlyData(level, layer, faceSlice);
+                if (!sourceData || !destData)
+                    return {};
+                for (auto row = 0; row < levelHeight; row += RowsPerBand)
+                    bands.push_back({ sourceData + sourceStride * row,
+                        destData + destStride * (row / 4), sourceStride,
+                        destStride, levelWidth,
+                        std::min(RowsPerBand, levelHeight - row) });
+            }
+        }
+    }
+
+    const auto sourceDXGIFormat = toDXGIFormat(sourceFormat);
+    const auto destDXGIFormat = toDXGIFormat(format);
+    const auto flags = getCompressFlags(quality);
+    // transparent texels of formats without alpha would decode as black
+    const auto alphaThreshold =
+        (format == TF::RGB_DXT1 || format == TF::SRGB_DXT1
+                ? 0.0f
+                : DirectX::TEX_THRESHOLD_DEFAULT);
+    const auto components = getCompressedComponentCount(format);
+    auto errors = std::vector<double>(bands.size());
+    auto failed = std::atomic<bool>{};
+    parallelFor(static_cast<int>(bands.size()), [&](int index) {
+        if (failed)
+            return;
+        const auto &band = bands[index];
+        const auto image = makeImage(sourceDXGIFormat, band.source,
+            band.sourceStride, band.width, band.height);
+        auto compressed = DirectX::ScratchImage{};
+        if (FAILED(DirectX::Compress(image, destDXGIFormat, flags,
+                alphaThreshold, compressed))) {
+            failed = true;
+            return;
+        }
+        const auto &result = *compressed.GetImage(0, 0, 0);
+        if (result.rowPitch != band.destStride) {
+            failed = true;
+            return;
+        }
+        std::memcpy(band.dest, result.pixels, result.slicePitch);
+
+        // compare in the source format, so sRGB data is not linearized
+        if (psnr) {
+            auto decompressed = DirectX::ScratchImage{};
+            auto mse = 0.0f;
+            auto channelMse = std::array<float, 4>{};
+            if (FAILED(DirectX::Decompress(result, sourceDXGIFormat,
+                    decompressed))
+                || FAILED(DirectX::ComputeMSE(*decompressed.GetImage(0, 0, 0),
+                    image, mse, channelMse.data()))) {
+                failed = true;
+                return;
+            }
+            auto error = 0.0;
+            for (auto i = 0; i < components; ++i)
+                error += channelMse[i];
+            errors[index] = error / components * band.width * band.height;
+        }
+    });
+    if (failed)
+        return {};
+
+    if (psnr) {
+        auto error = 0.0;
+        auto pixels = 0.0;
+        for (auto i = 0u; i < bands.size(); ++i) {
+            error += errors[i];
+            pixels += static_cast<double>(bands[i].width) * bands[i].height;
+        }
+        const auto peak = (sourceFormat == TF::RGBA8_SNorm ? 2.0 : 1.0);
+        *psnr = (error > 0
+                ? 10 * std::log10(peak * peak * pixels / error)
+                : std::numeric_limits<double>::infinity());
+    }
+
+    copy.setRowOrder(rowOrder());
+    copy.mKtxTexture->generateMipmaps = KTX_FALSE;
+    return copy;
+}
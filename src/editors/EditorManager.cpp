@@ -575,7 +575,11 @@ bool EditorManager::saveEditorAs()
         while (Singletons::fileDialog().exec(options, editor->fileName(),
             sourceType)) {
             editor->setFileName(Singletons::fileDialog().fileName());
-            if (!editor->save()) {
+            // renamed file has to exist before items are redirected to it
+            auto textureEditor =
+                qobject_cast<TextureEditor *>(mCurrentDock->widget());
+            if (!editor->save()
+                || (textureEditor && !textureEditor->waitForSave())) {
                 if (!showSavingFailedMessage(this, editor->fileName()))
                     break;
                 continue;
@@ -3,6 +3,7 @@
 #include "BinaryEditor_HexModel.h"
 #include "BinaryEditor_DataModel.h"
 #include "BinaryEditor_EditableRegion.h"
+#include "BinaryEditor_PagedData.h"
 #include "FileCache.h"
 #include "FileDialog.h"
 #include "Singletons.h"
@@ -84,6 +85,7 @@ BinaryEditor::BinaryEditor(QString fileName, BinaryEditorToolBar *editorToolbar,
     : QTableView(parent)
     , mEditorToolBar(*editorToolbar)
     , mFileName(fileName)
+    , mData(std::make_unique<PagedData>())
 {
     horizontalHeader()->setVisible(false);
     horizontalHeader()->setDefaultSectionSize(mColumnWidth + 3);
@@ -159,8 +161,11 @@ bool BinaryEditor::save()
     QSaveFile file(fileName());
     if (!file.open(QFile::WriteOnly | QFile::Truncate))
         return false;
-    file.write(mData);
-    if (!file.commit())
+    auto succeeded = true;
+    mData->forEachRange([&](const char *data, qsizetype size) {
+        succeeded &= (file.write(data, size) == size);
+    });
+    if (!succeeded || !file.commit())
         return false;
 
     setModified(false);
@@ -170,10 +175,10 @@ bool BinaryEditor::save()
 void BinaryEditor::replace(QByteArray data, bool emitFileChanged)
 {
     Q_ASSERT(!data.isNull());
-    if (data.isSharedWith(mData))
+    if (mData->isSharedWith(data))
         return;
 
-    mData = data;
+    mData->reset(data);
     refresh();
 
     if (!FileDialog::isEmptyOrUntitled(mFileName))
@@ -182,6 +187,29 @@ void BinaryEditor::replace(QByteArray data, bool emitFileChanged)
     Singletons::fileCache().handleEditorFileChanged(mFileName, emitFileChanged);
 }
 
+void BinaryEditor::replaceRange(qsizetype offset, const QByteArray &range)
+{
+    if (offset + range.size() <= mData->size()) {
+        auto current = QByteArray(range.size(), Qt::Uninitialized);
+        mData->read(offset, current.data(), current.size());
+        if (current == range)
+            return;
+    }
+    mData->write(offset, range.constData(), range.size());
+    refresh();
+    handleDataChanged();
+}
+
+QByteArray BinaryEditor::data() const
+{
+    return mData->toByteArray();
+}
+
+void BinaryEditor::updateData(QByteArray *data)
+{
+    mData->update(data);
+}
+
 void BinaryEditor::handleDataChanged()
 {
     setModified(true);
@@ -234,7 +262,7 @@ void BinaryEditor::refresh()
         stride = 16;
     }
 
-    mHexModel->setDataSpan(&mData, offset, stride, rowCount);
+    mHexModel->setDataSpan(mData.get(), offset, stride, rowCount);
 
     clearSpans();
     setRowHeight(mPrevFirstRow, mRowHeight);
@@ -245,7 +273,7 @@ void BinaryEditor::refresh()
         const auto row = (offset + stride - 1) / stride;
         setSpan(row, 0, rowCount, stride);
 
-        mDataModel->setData(&mData, *block);
+        mDataModel->setData(mData.get(), *block);
 
         mEditableRegion->horizontalHeader()->setMinimumSectionSize(1);
         for (auto i = 0; i < mDataModel->columnCount({}); ++i)
@@ -2,6 +2,7 @@
 
 #include "editors/IEditor.h"
 #include <QTableView>
+#include <memory>
 
 class BinaryEditorToolBar;
 
@@ -55,7 +56,9 @@ public:
     void setModified() override;
     bool isModified() const { return mModified; }
     void replace(QByteArray data, bool emitFileChanged = true);
-    const QByteArray &data() const { return mData; }
+    void replaceRange(qsizetype offset, const QByteArray &range);
+    QByteArray data() const;
+    void updateData(QByteArray *data);
     void setBlocks(QList<Block> blocks);
     const QList<Block> &blocks() const { return mBlocks; }
     void setCurrentBlockIndex(int index);
@@ -74,6 +77,7 @@ private:
     class EditableRegionDelegate;
     class DataModel;
     class HexModel;
+    class PagedData;
 
     void handleDataChanged();
     void setModified(bool modified);
@@ -84,7 +88,7 @@ private:
     BinaryEditorToolBar &mEditorToolBar;
     QString mFileName;
     bool mModified{};
-    QByteArray mData;
+    std::unique_ptr<PagedData> mData;
     HexModel *mHexModel{};
     DataModel *mDataModel{};
     EditableRegion *mEditableRegion{};
@@ -1,7 +1,8 @@
 #pragma once
 
-#include "BinaryEditor.h"
+#include "BinaryEditor_PagedData.h"
 #include <QAbstractTableModel>
+#include <array>
 
 namespace {
     template <typename T>
@@ -27,7 +28,7 @@ public:
     {
     }
 
-    void setData(QByteArray *data, const BinaryEditor::Block &block)
+    void setData(PagedData *data, const BinaryEditor::Block &block)
     {
         const auto prevData = mData;
         const auto prevOffset = mOffset;
@@ -98,7 +99,8 @@ public:
             return static_cast<int>(Qt::AlignHCenter | Qt::AlignVCenter);
         }
 
-        const auto offset = mOffset + mStride * index.row() + column.offset;
+        const auto offset = qsizetype{ mOffset } + qsizetype{ mStride }
+            * index.row() + column.offset;
         const auto columnSize = getTypeSize(column.type);
         if (column.offset + columnSize > mStride
             || offset + columnSize > mData->size())
@@ -119,8 +121,9 @@ public:
             if (column.offset + columnSize > mStride)
                 return false;
 
-            const auto offset = mOffset + mStride * index.row();
-            expand(offset + mStride);
+            const auto offset =
+                qsizetype{ mOffset } + qsizetype{ mStride } * index.row();
+            mData->expand(offset + mStride);
 
             setData(offset + column.offset, column.type, variant);
         }
@@ -170,14 +173,16 @@ private:
         return mColumns[index];
     }
 
-    uint8_t getByte(int offset) const
+    uint8_t getByte(qsizetype offset) const
     {
-        return static_cast<uint8_t>(mData->constData()[offset]);
+        return mData->getByte(offset);
     }
 
-    QVariant getData(int offset, DataType type) const
+    QVariant getData(qsizetype offset, DataType type) const
     {
-        auto data = mData->constData() + offset;
+        auto value = std::array<char, 8>{ };
+        mData->read(offset, value.data(), getTypeSize(type));
+        const auto data = value.data();
         switch (type) {
         case DataType::Int8:   return get<int8_t>(data);
         case DataType::Int16:  return get<int16_t>(data);
@@ -193,9 +198,10 @@ private:
         return {};
     }
 
-    void setData(int offset, DataType type, QVariant v)
+    void setData(qsizetype offset, DataType type, QVariant v)
     {
-        auto data = mData->data() + offset;
+        auto value = std::array<char, 8>{ };
+        const auto data = value.data();
         switch (type) {
         case DataType::Int8:   set<int8_t>(data, v.toInt()); break;
         case DataType::Int16:  set<int16_t>(data, v.toInt()); break;
@@ -208,17 +214,11 @@ private:
         case DataType::Float:  set<float>(data, v.toFloat()); break;
         case DataType::Double: set<double>(data, v.toDouble()); break;
         }
-    }
-
-    void expand(int requiredSize)
-    {
-        if (requiredSize > mData->size()) {
-            mData->append(QByteArray(requiredSize - mData->size(), 0));
-        }
+        mData->write(offset, value.data(), getTypeSize(type));
     }
 
     BinaryEditor &mEditor;
-    QByteArray *mData{};
+    PagedData *mData{};
     int mOffset{};
     int mStride{};
     int mRowCount{};
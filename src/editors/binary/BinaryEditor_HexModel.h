@@ -1,7 +1,8 @@
 #pragma once
 
-#include "BinaryEditor.h"
+#include "BinaryEditor_PagedData.h"
 #include <QAbstractTableModel>
+#include <limits>
 
 class BinaryEditor::HexModel final : public QAbstractTableModel
 {
@@ -9,7 +10,8 @@ class BinaryEditor::HexModel final : public QAbstractTableModel
 public:
     HexModel(QObject *parent = nullptr) : QAbstractTableModel(parent) { }
 
-    void setDataSpan(const QByteArray *data, int offset, int stride, int rowCount)
+    void setDataSpan(const PagedData *data, int offset, int stride,
+        int rowCount)
     {
         const auto prevData = mData;
         const auto prevOffset = mOffset;
@@ -22,7 +24,9 @@ public:
 
         const auto lastRow = (mOffset + mStride * rowCount + mStride - 1)
             / mStride;
-        rowCount = mData->size() / mStride + 2;
+        // views can not show more rows than fit in an int
+        rowCount = static_cast<int>(std::min(mData->size() / mStride + 2,
+            qsizetype{ std::numeric_limits<int>::max() }));
         while (getOffset(rowCount - 1, 0) >= mData->size())
             --rowCount;
         mRowCount = std::max(rowCount, lastRow);
@@ -39,9 +43,9 @@ public:
 
     int columnCount(const QModelIndex &) const override { return mStride; }
 
-    int getOffset(int row, int column) const
+    qsizetype getOffset(int row, int column) const
     {
-        return mStride * row + column
+        return qsizetype{ mStride } * row + column
             - (mStride - (mOffset % mStride)) % mStride;
     }
 
@@ -66,7 +70,7 @@ public:
         if (offset < 0 || offset >= mData->size())
             return QVariant();
 
-        return toHexString(static_cast<uint8_t>(mData->constData()[offset]));
+        return toHexString(mData->getByte(offset));
     }
 
     QVariant headerData(int section, Qt::Orientation orientation,
@@ -86,7 +90,7 @@ public:
     Qt::ItemFlags flags(const QModelIndex &) const override { return {}; }
 
 private:
-    const QByteArray *mData{};
+    const PagedData *mData{};
     int mOffset{};
     int mStride{};
     int mRowCount{};
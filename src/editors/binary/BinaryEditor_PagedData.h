@@ -0,0 +1,175 @@
+#pragma once
+
+#include "BinaryEditor.h"
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// keeps the loaded data untouched and stores edits in copies of the
+// modified pages
+class BinaryEditor::PagedData final
+{
+public:
+    static constexpr qsizetype PageSize = 4096;
+
+    void reset(QByteArray data)
+    {
+        mData = std::move(data);
+        mSize = mData.size();
+        mPages.clear();
+        mDirtyPages.clear();
+        mAllDirty = true;
+    }
+
+    bool isSharedWith(const QByteArray &data) const
+    {
+        return (mPages.isEmpty() && mSize == mData.size()
+            && mData.isSharedWith(data));
+    }
+
+    qsizetype size() const { return mSize; }
+
+    void expand(qsizetype size) { mSize = std::max(mSize, size); }
+
+    void read(qsizetype offset, void *data, qsizetype size) const
+    {
+        Q_ASSERT(offset >= 0 && offset + size <= mSize);
+        auto dest = static_cast<char *>(data);
+        while (size > 0) {
+            const auto [page, pageOffset, count] = getRange(offset, size);
+            if (const auto it = mPages.find(page); it != mPages.end()) {
+                std::memcpy(dest, it->constData() + pageOffset, count);
+            } else {
+                const auto available =
+                    std::clamp(mData.size() - offset, qsizetype{ }, count);
+                if (available > 0)
+                    std::memcpy(dest, mData.constData() + offset, available);
+                std::memset(dest + available, 0, count - available);
+            }
+            dest += count;
+            offset += count;
+            size -= count;
+        }
+    }
+
+    void write(qsizetype offset, const void *data, qsizetype size)
+    {
+        expand(offset + size);
+        auto source = static_cast<const char *>(data);
+        while (size > 0) {
+            const auto [page, pageOffset, count] = getRange(offset, size);
+            std::memcpy(getWritablePage(page).data() + pageOffset, source,
+                count);
+            mDirtyPages.insert(page);
+            source += count;
+            offset += count;
+            size -= count;
+        }
+    }
+
+    uint8_t getByte(qsizetype offset) const
+    {
+        auto value = uint8_t{ };
+        read(offset, &value, 1);
+        return value;
+    }
+
+    // calls function with consecutive ranges, unmodified pages are merged
+    template <typename F>
+    void forEachRange(const F &function) const
+    {
+        static const auto zeroes = QByteArray(PageSize, 0);
+        auto offset = qsizetype{ };
+        while (offset < mSize) {
+            const auto page = offset / PageSize;
+            if (const auto it = mPages.find(page); it != mPages.end()) {
+                const auto count = std::min(PageSize, mSize - offset);
+                function(it->constData(), count);
+                offset += count;
+            } else if (offset < mData.size()) {
+                auto end = offset;
+                while (end < std::min(mData.size(), mSize)
+                    && !mPages.contains(end / PageSize))
+                    end = (end / PageSize + 1) * PageSize;
+                end = std::min({ end, mData.size(), mSize });
+                function(mData.constData() + offset, end - offset);
+                offset = end;
+            } else {
+                const auto count =
+                    std::min((page + 1) * PageSize, mSize) - offset;
+                function(zeroes.constData(), count);
+                offset += count;
+            }
+        }
+    }
+
+    QByteArray toByteArray() const
+    {
+        if (mPages.isEmpty() && mSize == mData.size())
+            return mData;
+        auto data = QByteArray();
+        data.reserve(mSize);
+        forEachRange([&](const char *range, qsizetype size) {
+            data.append(range, size);
+        });
+        return data;
+    }
+
+    // applies the pages modified since the last update to a merged copy,
+    // which is only rebuilt after a reset or when the size changed
+    void update(QByteArray *data)
+    {
+        Q_ASSERT(data);
+        if (std::exchange(mAllDirty, false) || data->size() != mSize) {
+            *data = toByteArray();
+        } else {
+            for (auto page : std::as_const(mDirtyPages)) {
+                const auto offset = page * PageSize;
+                const auto count = std::min(PageSize, mSize - offset);
+                if (count > 0)
+                    std::memcpy(data->data() + offset,
+                        mPages[page].constData(), count);
+            }
+        }
+        mDirtyPages.clear();
+    }
+
+private:
+    struct Range
+    {
+        qsizetype page;
+        qsizetype pageOffset;
+        qsizetype count;
+    };
+
+    static Range getRange(qsizetype offset, qsizetype size)
+    {
+        const auto page = offset / PageSize;
+        const auto pageOffset = offset % PageSize;
+        return { page, pageOffset, std::min(size, PageSize - pageOffset) };
+    }
+
+    QByteArray &getWritablePage(qsizetype page)
+    {
+        auto it = mPages.find(page);
+        if (it == mPages.end()) {
+            auto data = QByteArray(PageSize, 0);
+            const auto offset = page * PageSize;
+            const auto available =
+                std::clamp(mData.size() - offset, qsizetype{ }, PageSize);
+            if (available > 0)
+                std::memcpy(data.data(), mData.constData() + offset,
+                    available);
+            it = mPages.insert(page, data);
+        }
+        return *it;
+    }
+
+    QByteArray mData;
+    qsizetype mSize{ };
+    QHash<qsizetype, QByteArray> mPages;
+    QSet<qsizetype> mDirtyPages;
+    bool mAllDirty{ true };
+};
@@ -87,10 +87,14 @@ TextureEditor::TextureEditor(QString fileName,
 
     verticalScrollBar()->hide();
     horizontalScrollBar()->hide();
+
+    // saves of the same file must not overlap
+    mSaveThreadPool.setMaxThreadCount(1);
 }
 
 TextureEditor::~TextureEditor()
 {
+    mSaveThreadPool.waitForDone();
     releaseRenderWidget();
 
     Singletons::fileCache().invalidateFile(mFileName);
@@ -349,19 +353,83 @@ int TextureEditor::tabifyGroup() const
 }
 
 bool TextureEditor::save()
+{
+    return save(mKtxOptions);
+}
+
+bool TextureEditor::save(const TextureData::KtxOptions &options)
 {
     auto texture = mTexture;
     if (!mTextureItem->downloadImage(&texture))
         return false;
 
+    // encoding and supercompression are slow, so they run in background
+    const auto encodeKtx2 =
+        ((options.encoding != TextureData::KtxEncoding::None
+             || options.zstdLevel > 0)
+            && FileDialog::getFileExtension(fileName()) == "ktx2");
+    if (encodeKtx2) {
+        // modified flag is cleared once the file was written
+        mSavePending = true;
+        saveInBackground(texture, options);
+        mTexture = std::move(texture);
+        return true;
+    }
+    mSaveThreadPool.waitForDone();
     if (!texture.save(fileName()))
         return false;
 
+    mSaveSucceeded = true;
     mTexture = std::move(texture);
     setModified(false);
     return true;
 }
 
+void TextureEditor::setKtxOptions(const TextureData::KtxOptions &options)
+{
+    mKtxOptions = options;
+}
+
+bool TextureEditor::waitForSave()
+{
+    mSaveThreadPool.waitForDone();
+    return mSaveSucceeded;
+}
+
+void TextureEditor::saveInBackground(TextureData texture,
+    const TextureData::KtxOptions &options)
+{
+    const auto updateProgress = [this, fileName = fileName()](int percent) {
+        QMetaObject::invokeMethod(
+            this,
+            [this, fileName, percent]() {
+                mSaveMessages.clear();
+                if (percent < 0) {
+                    mSaveMessages.insert(fileName, 0,
+                        MessageType::WritingFileFailed, fileName);
+                    mSavePending = false;
+                    setModified(true);
+                } else if (percent == 100) {
+                    // keep flag when texture was modified while saving
+                    if (std::exchange(mSavePending, false))
+                        setModified(false);
+                } else {
+                    mSaveMessages.insert(fileName, 0, MessageType::SavingFile,
+                        QString::number(percent));
+                }
+            },
+            Qt::QueuedConnection);
+    };
+
+    mSaveThreadPool.start([this, texture = std::move(texture),
+                              fileName = fileName(), options,
+                              updateProgress]() {
+        mSaveSucceeded = texture.saveKtx2(fileName, options, updateProgress);
+        if (!mSaveSucceeded)
+            updateProgress(-1);
+    });
+}
+
 void TextureEditor::replace(TextureData texture, bool emitFileChanged)
 {
     if (!mTextureItem || texture.isNull() || texture == mTexture) {
@@ -429,6 +497,8 @@ void TextureEditor::setModified()
 
 void TextureEditor::setModified(bool modified)
 {
+    if (modified)
+        mSavePending = false;
     if (mModified != modified) {
         mModified = modified;
         Q_EMIT modificationChanged(modified);
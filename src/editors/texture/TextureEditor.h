@@ -1,10 +1,13 @@
 #pragma once
 
+#include "MessageList.h"
 #include "TextureData.h"
 #include "editors/IEditor.h"
 #include "render/ShareHandle.h"
 #include "widgets/WindowWidget.h"
 #include <QFrame>
+#include <QThreadPool>
+#include <atomic>
 
 class QScrollBar;
 class TextureEditorItem;
@@ -35,6 +38,9 @@ public:
     void setRawFormat(RawFormat rawFormat);
     bool load() override;
     bool save() override;
+    bool save(const TextureData::KtxOptions &options);
+    void setKtxOptions(const TextureData::KtxOptions &options);
+    bool waitForSave();
     void copy();
     int tabifyGroup() const override;
     void setModified() override;
@@ -76,6 +82,8 @@ private:
     void setZoom(int zoom);
     double getZoomScale() const;
     void setModified(bool modified);
+    void saveInBackground(TextureData texture,
+        const TextureData::KtxOptions &options);
     void updateEditorToolBar();
     void updateScrollBars();
     int margin() const;
@@ -96,6 +104,11 @@ private:
     bool mIsRaw{};
     bool mModified{};
     TextureData mTexture;
+    TextureData::KtxOptions mKtxOptions{};
+    QThreadPool mSaveThreadPool;
+    std::atomic<bool> mSaveSucceeded{ true };
+    bool mSavePending{};
+    MessagePtrSet mSaveMessages;
     bool mPan{};
     QRect mBounds{};
     bool mZoomToFit{};
@@ -11,6 +11,8 @@
 #include "scripting/ScriptEngine.h"
 #include "editors/EditorManager.h"
 #include "editors/IEditor.h"
+#include "editors/texture/TextureEditor.h"
+#include "render/BatchCompiler.h"
 #include <QApplication>
 #include <QSettings>
 #include <QSurfaceFormat>
@@ -124,10 +126,23 @@ void outputHelpToStdout()
         "\n"
         "Usage: gpupad [--options] <filenames>\n"
         "  --headless                        run in headless mode.\n"
+        "  --compile                         compile shaders of sessions,\n"
+        "                                    files and directories to SPIR-V.\n"
         "  --help                            print this help.\n"
         "\n"
         "In headless mode the following parameters are available:\n"
         "  --output <item-ident> <filename>  output an item's data to a file.\n"
+        "  --ktx-encoding <none|uastc|etc1s> encode following KTX2 outputs.\n"
+        "  --ktx-zstd <level>                supercompress following KTX2\n"
+        "                                    outputs with Zstandard (1-22).\n"
+        "\n"
+        "In compile mode the following parameters are available:\n"
+        "  --output-dir <directory>          write outputs to directory,\n"
+        "                                    otherwise only validate.\n"
+        "  --glsl                            also output GLSL.\n"
+        "  --hlsl                            also output HLSL.\n"
+        "  --report <filename>               write a JSON report to a file.\n"
+        "  --threads <count>                 limit number of threads.\n"
         "\n"
         "All Rights Reserved.\n"
         "This program comes with absolutely no warranty.\n"
@@ -171,6 +186,7 @@ int runHeadless(int argc, char *argv[])
     auto &sessionModel = singletons.sessionModel();
     auto &synchronizeLogic = singletons.synchronizeLogic();
     auto editorsToSave = std::map<QString, IEditor *>();
+    auto ktxOptions = TextureData::KtxOptions{ };
     auto messages = MessagePtrSet{ };
 
     const auto toAbsoluteFileName = [workingDirectory = QDir::current()](
@@ -190,11 +206,15 @@ int runHeadless(int argc, char *argv[])
     const auto evaluateSession = [&]() {
         synchronizeLogic.manualEvaluation();
         synchronizeLogic.finishEvaluation();
-        for (auto [itemIdent, editor] : std::exchange(editorsToSave, { }))
-            if (!editor->save()) {
+        for (auto [itemIdent, editor] : std::exchange(editorsToSave, { })) {
+            auto textureEditor =
+                editorManager.getTextureEditor(editor->fileName());
+            if (!editor->save()
+                || (textureEditor && !textureEditor->waitForSave())) {
                 invalidArgument("saving item '" + itemIdent + "' failed");
                 return false;
             }
+        }
         return true;
     };
 
@@ -251,10 +271,36 @@ int runHeadless(int argc, char *argv[])
                 if (sessionModel.setData(index, fileName))
                     if (const auto fileItem = castItem<FileItem>(item))
                         if (auto editor = editorManager.openEditor(*fileItem)) {
+                            if (auto textureEditor =
+                                    editorManager.getTextureEditor(fileName))
+                                textureEditor->setKtxOptions(ktxOptions);
                             editorsToSave[itemIdent] = editor;
                             continue;
                         }
                 return invalidArgument("invalid file item '" + itemIdent + "'");
+            } else if (argument == "--ktx-encoding") {
+                if (!checkParameterCount(1))
+                    return invalidArgument("missing parameter to " + argument);
+
+                const auto encoding = arguments[++i].toLower();
+                if (encoding == "none") {
+                    ktxOptions.encoding = TextureData::KtxEncoding::None;
+                } else if (encoding == "uastc") {
+                    ktxOptions.encoding = TextureData::KtxEncoding::UASTC;
+                } else if (encoding == "etc1s") {
+                    ktxOptions.encoding = TextureData::KtxEncoding::ETC1S;
+                } else {
+                    return invalidArgument("invalid KTX encoding " + encoding);
+                }
+            } else if (argument == "--ktx-zstd") {
+                if (!checkParameterCount(1))
+                    return invalidArgument("missing parameter to " + argument);
+
+                auto ok = false;
+                ktxOptions.zstdLevel = arguments[++i].toInt(&ok);
+                if (!ok || ktxOptions.zstdLevel < 0
+                    || ktxOptions.zstdLevel > 22)
+                    return invalidArgument("invalid Zstandard level");
             } else {
                 return invalidArgument("unknown option " + argument);
             }
@@ -282,6 +328,89 @@ int runHeadless(int argc, char *argv[])
     return 0;
 }
 
+int runCompile(int argc, char *argv[])
+{
+    auto app = QApplication(argc, argv);
+    defaultMessageHandler = qInstallMessageHandler(filteringMessageHandler);
+    attachToConsole();
+
+    auto singletons = Singletons(nullptr);
+    auto &sessionModel = singletons.sessionModel();
+    auto messages = MessagePtrSet{ };
+    auto options = BatchCompiler::Options{ };
+    auto reportFileName = QString();
+    auto inputs = QStringList();
+
+    const auto toAbsoluteFileName = [workingDirectory = QDir::current()](
+                                        const QString &fileName) {
+        return toNativeCanonicalFilePath(
+            workingDirectory.absoluteFilePath(fileName));
+    };
+    const auto invalidArgument = [&](QString message) {
+        messages.insert(MessageType::InvalidCommandlineArguments, message);
+        outputMessagesToStdout();
+        return 1;
+    };
+
+    auto arguments = app.arguments();
+    arguments.removeFirst();
+    for (auto i = 0; i < arguments.size(); ++i) {
+        const auto &argument = arguments[i];
+        const auto hasParameter = (i + 1 < arguments.size()
+            && !arguments[i + 1].startsWith("--"));
+
+        if (argument == "--compile") {
+            continue;
+        } else if (argument == "--help") {
+            outputHelpToStdout();
+            return 0;
+        } else if (argument == "--glsl") {
+            options.generateGLSL = true;
+        } else if (argument == "--hlsl") {
+            options.generateHLSL = true;
+        } else if (argument == "--output-dir" && hasParameter) {
+            options.outputDirectory = toAbsoluteFileName(arguments[++i]);
+        } else if (argument == "--report" && hasParameter) {
+            reportFileName = toAbsoluteFileName(arguments[++i]);
+        } else if (argument == "--threads" && hasParameter) {
+            options.threadCount = arguments[++i].toInt();
+        } else if (argument.startsWith("--")) {
+            return invalidArgument("invalid option " + argument);
+        } else {
+            inputs.append(toAbsoluteFileName(argument));
+        }
+    }
+    if (inputs.isEmpty())
+        return invalidArgument("no input files");
+
+    auto compiler = BatchCompiler(options);
+    for (const auto &fileName : std::as_const(inputs)) {
+        if (QFileInfo(fileName).isDir()) {
+            compiler.addDirectory(QDir(fileName));
+        } else if (FileDialog::isSessionFileName(fileName)) {
+            if (sessionModel.load(fileName))
+                compiler.addSession(sessionModel);
+            else
+                messages.insert(MessageType::LoadingFileFailed, fileName);
+            sessionModel.clear();
+        } else if (!compiler.addFile(fileName)) {
+            messages.insert(MessageType::LoadingFileFailed, fileName);
+        }
+    }
+
+    const auto succeeded = compiler.run();
+    compiler.outputSummaryToStdout();
+    outputMessagesToStdout();
+
+    if (!reportFileName.isEmpty()) {
+        auto file = QFile(reportFileName);
+        if (!file.open(QIODevice::WriteOnly)
+            || file.write(compiler.getReport()) < 0)
+            return invalidArgument("writing report failed");
+    }
+    return (succeeded && messages.isEmpty() ? 0 : 1);
+}
+
 int run(int argc, char *argv[])
 {
     auto app = QApplication(argc, argv);
@@ -383,6 +512,13 @@ int main(int argc, char *argv[])
         if (arg1 == "--headless")
             return runHeadless(argc, argv);
 
+        if (arg1 == "--compile") {
+#if defined(__linux)
+            setenv("QT_QPA_PLATFORM", "offscreen", 1);
+#endif
+            return runCompile(argc, argv);
+        }
+
         attachToConsole();
         outputHelpToStdout();
         return (arg1 == "--help" ? 0 : 1);
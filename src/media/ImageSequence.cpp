@@ -0,0 +1,175 @@
+#include "ImageSequence.h"
+
+#if defined(MULTIMEDIA_ENABLED)
+
+#  include <QDir>
+#  include <QFileInfo>
+#  include <QRegularExpression>
+#  include <QThread>
+#  include <algorithm>
+
+namespace {
+    constexpr auto FramesPerSecond = 60;
+    constexpr auto ReadAheadFrames = 8;
+
+    QStringList getFrameFileNames(const QString &fileName)
+    {
+        static const auto placeholder = QRegularExpression("%\\d+d");
+        const auto fileInfo = QFileInfo(fileName);
+        const auto name = fileInfo.fileName();
+        const auto match = placeholder.match(name);
+        if (!match.hasMatch())
+            return { };
+
+        const auto pattern = QRegularExpression("^"
+            + QRegularExpression::escape(name.left(match.capturedStart()))
+            + "(\\d+)"
+            + QRegularExpression::escape(name.mid(match.capturedEnd()))
+            + "$");
+
+        // order frames by number, not lexicographically
+        const auto directory = fileInfo.dir();
+        auto frames = std::map<int, QString>();
+        for (const auto &entry : directory.entryList(QDir::Files))
+            if (const auto frame = pattern.match(entry); frame.hasMatch())
+                frames.emplace(frame.captured(1).toInt(),
+                    directory.filePath(entry));
+
+        auto fileNames = QStringList();
+        for (const auto &[number, frameFileName] : frames)
+            fileNames.append(frameFileName);
+        return fileNames;
+    }
+} // namespace
+
+ImageSequence::ImageSequence(QString fileName, QObject *parent)
+    : VideoStream(fileName, parent)
+    , mFrameFileNames(getFrameFileNames(fileName))
+{
+    mThreadPool.setMaxThreadCount(
+        std::clamp(QThread::idealThreadCount() / 2, 1, ReadAheadFrames));
+
+    // loading finished is signaled when the first frame is presented
+    if (mFrameFileNames.isEmpty()) {
+        QMetaObject::invokeMethod(this, &VideoStream::loadingFinished,
+            Qt::QueuedConnection);
+        return;
+    }
+    mStatisticsTimer.start();
+    readAhead();
+}
+
+ImageSequence::~ImageSequence()
+{
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+}
+
+int ImageSequence::getFrameIndex(std::chrono::milliseconds time) const
+{
+    const auto frameCount = static_cast<qint64>(mFrameFileNames.size());
+    const auto frame = time.count() * FramesPerSecond / 1000;
+    return static_cast<int>((frame % frameCount + frameCount) % frameCount);
+}
+
+bool ImageSequence::isReadAhead(int frameIndex) const
+{
+    const auto frameCount = static_cast<int>(mFrameFileNames.size());
+    const auto distance =
+        (frameIndex - mCurrentFrame + frameCount) % frameCount;
+    return (distance < ReadAheadFrames);
+}
+
+void ImageSequence::readAhead()
+{
+    const auto frameCount = static_cast<int>(mFrameFileNames.size());
+    const auto count = std::min(ReadAheadFrames, frameCount);
+    for (auto i = 0; i < count; ++i) {
+        const auto frameIndex = (mCurrentFrame + i) % frameCount;
+        if (mFrames.count(frameIndex) || mLoadingFrames.contains(frameIndex)
+            || mFailedFrames.contains(frameIndex))
+            continue;
+
+        // frames are skipped when they are no longer needed when dequeued
+        mLoadingFrames.insert(frameIndex);
+        mThreadPool.start(
+            [this, frameIndex, fileName = mFrameFileNames[frameIndex]]() {
+                auto texture = TextureData();
+                auto failed = false;
+                if (isReadAhead(frameIndex))
+                    failed = !texture.load(fileName);
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, frameIndex, texture = std::move(texture),
+                        failed]() {
+                        handleFrameLoaded(frameIndex, texture, failed);
+                    },
+                    Qt::QueuedConnection);
+            },
+            ReadAheadFrames - i);
+    }
+}
+
+void ImageSequence::handleFrameLoaded(int frameIndex, TextureData texture,
+    bool failed)
+{
+    Q_ASSERT(onMainThread());
+    mLoadingFrames.remove(frameIndex);
+
+    // frames which failed to load are not requested again, the sequence
+    // is recreated when one of its files changes
+    if (failed)
+        mFailedFrames.insert(frameIndex);
+
+    if (texture.isNull()) {
+        // the sequence is unusable when not even the first frame loads
+        if (!width() && frameIndex == mCurrentFrame)
+            Q_EMIT loadingFinished();
+        return;
+    }
+    if (!isReadAhead(frameIndex))
+        return;
+
+    mFrames[frameIndex] = texture;
+    if (frameIndex == mCurrentFrame)
+        showFrame(texture);
+}
+
+void ImageSequence::showFrame(const TextureData &texture)
+{
+    presentTexture(texture);
+
+    ++mPresentedFrames;
+    const auto elapsed = mStatisticsTimer.elapsed();
+    if (elapsed >= 1000) {
+        mFramesPerSecond = mPresentedFrames * 1000.0 / elapsed;
+        mPresentedFrames = 0;
+        mStatisticsTimer.restart();
+    }
+}
+
+void ImageSequence::seek(std::chrono::milliseconds time)
+{
+    if (mFrameFileNames.isEmpty())
+        return;
+
+    const auto frameIndex = getFrameIndex(time);
+    if (frameIndex == mCurrentFrame)
+        return;
+    mCurrentFrame = frameIndex;
+
+    // drop frames which are no longer ahead of the current frame
+    for (auto it = mFrames.begin(); it != mFrames.end();)
+        if (!isReadAhead(it->first)) {
+            it = mFrames.erase(it);
+        } else {
+            ++it;
+        }
+
+    if (const auto it = mFrames.find(frameIndex); it != mFrames.end())
+        showFrame(it->second);
+
+    readAhead();
+}
+
+#endif // defined(MULTIMEDIA_ENABLED)
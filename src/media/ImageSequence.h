@@ -0,0 +1,41 @@
+#pragma once
+
+#if defined(MULTIMEDIA_ENABLED)
+
+#  include "VideoStream.h"
+#  include "TextureData.h"
+#  include <QElapsedTimer>
+#  include <QSet>
+#  include <QStringList>
+#  include <QThreadPool>
+#  include <atomic>
+#  include <map>
+
+class ImageSequence final : public VideoStream
+{
+public:
+    ImageSequence(QString fileName, QObject *parent = nullptr);
+    ~ImageSequence() override;
+
+    void seek(std::chrono::milliseconds time) override;
+    double framesPerSecond() const override { return mFramesPerSecond; }
+
+private:
+    int getFrameIndex(std::chrono::milliseconds time) const;
+    bool isReadAhead(int frameIndex) const;
+    void readAhead();
+    void handleFrameLoaded(int frameIndex, TextureData texture, bool failed);
+    void showFrame(const TextureData &texture);
+
+    QStringList mFrameFileNames;
+    QThreadPool mThreadPool;
+    std::atomic<int> mCurrentFrame{ };
+    std::map<int, TextureData> mFrames;
+    QSet<int> mLoadingFrames;
+    QSet<int> mFailedFrames;
+    QElapsedTimer mStatisticsTimer;
+    int mPresentedFrames{ };
+    double mFramesPerSecond{ };
+};
+
+#endif // defined(MULTIMEDIA_ENABLED)
@@ -3,6 +3,7 @@
 #include "FileCache.h"
 #include "Singletons.h"
 #include "VideoPlayer.h"
+#include "ImageSequence.h"
 #include "Camera.h"
 #include "AudioSpectrum.h"
 #include "FileDialog.h"
@@ -44,6 +45,8 @@ void MediaManager::handleMediaRequested(const QString &fileName,
         videoStream = new AudioSpectrum(fileName, resolution);
     } else if (FileDialog::isCameraFileName(fileName)) {
         videoStream = new Camera(fileName);
+    } else if (FileDialog::isSequenceFileName(fileName)) {
+        videoStream = new ImageSequence(fileName);
     } else {
         videoStream = new VideoPlayer(fileName);
     }
@@ -64,6 +67,12 @@ void MediaManager::handleMediaLoaded()
     }
 }
 
+double MediaManager::getFramesPerSecond(const QString &fileName) const
+{
+    const auto it = mVideoStreams.find(fileName);
+    return (it != mVideoStreams.end() ? it->second->framesPerSecond() : 0);
+}
+
 void MediaManager::seekToTargetTime()
 {
     for (const auto &[fileName, videoStream] : mVideoStreams)
@@ -100,6 +109,10 @@ void MediaManager::unloadFiles(std::function<bool(const QString &)> predicate)
 {
 }
 void MediaManager::handleMediaRequested(const QString &, QSize resolution) { }
+double MediaManager::getFramesPerSecond(const QString &fileName) const
+{
+    return 0;
+}
 void MediaManager::seek(double time) { }
 void MediaManager::pause() { }
 
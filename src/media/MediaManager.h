@@ -22,6 +22,7 @@ public:
     void seek(double time);
     void pause();
     void handleMediaRequested(const QString &fileName, QSize resolution);
+    double getFramesPerSecond(const QString &fileName) const;
 
 private:
     void handleMediaLoaded();
@@ -2,7 +2,6 @@
 
 #  include "VideoPlayer.h"
 #  include "TextureData.h"
-#  include "FileDialog.h"
 #  include <QVideoSink>
 
 namespace {
@@ -52,14 +51,9 @@ void VideoPlayer::handleStatusChanged(QMediaPlayer::MediaStatus status)
 
 void VideoPlayer::handleFrameDecoded(QVideoFrame frame)
 {
-    if (!width()) {
+    if (!width())
         mDuration = std::chrono::milliseconds(mPlayer->duration());
 
-        // speedup image sequences from 25 to 60 fps
-        if (FileDialog::isSequenceFileName(fileName()))
-            mPlaybackSpeed = 2.4;
-    }
-
     if (!frame.isValid()) {
         mPlayer->pause();
         return;
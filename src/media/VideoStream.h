@@ -17,6 +17,7 @@ public:
     int width() const { return mWidth; }
     int height() const { return mHeight; }
     virtual void seek(std::chrono::milliseconds targetTime) = 0;
+    virtual double framesPerSecond() const { return 0; }
 
 Q_SIGNALS:
     void loadingFinished();
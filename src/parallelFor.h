@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+
+// pool shared by the CPU texture processing
+inline QThreadPool &getParallelForThreadPool()
+{
+    static auto threadPool = QThreadPool();
+    return threadPool;
+}
+
+// calls function for each index on the thread pool. the calling thread
+// also processes indices and workers are only started when a thread is
+// available, so it never waits for tasks which were not started
+template <typename F>
+void parallelFor(int count, const F &function)
+{
+    auto &threadPool = getParallelForThreadPool();
+    auto next = std::atomic<int>{ };
+    auto finished = QSemaphore();
+    const auto work = [&]() {
+        for (auto index = next++; index < count; index = next++)
+            function(index);
+    };
+    auto workers = 0;
+    while (workers < std::min(count, threadPool.maxThreadCount()) - 1
+        && threadPool.tryStart([&]() {
+               work();
+               finished.release();
+           }))
+        ++workers;
+    work();
+    finished.acquire(workers);
+}
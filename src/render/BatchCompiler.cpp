@@ -0,0 +1,349 @@
+#include "BatchCompiler.h"
+#include "ShaderBase.h"
+#include "FileCache.h"
+#include "FileDialog.h"
+#include "JSON.h"
+#include "Singletons.h"
+#include "SourceType.h"
+#include "session/SessionModel.h"
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstdio>
+
+struct BatchCompiler::Job
+{
+    Shader::ShaderType shaderType;
+    QList<Shader> shaders;
+    Session session;
+    QString outputBaseName;
+    bool outputCollides{};
+    QStringList outputFileNames;
+    MessagePtrSet messages;
+    bool succeeded{};
+};
+
+namespace {
+    const char *getStageExtension(Shader::ShaderType shaderType)
+    {
+        using ST = Shader::ShaderType;
+        switch (shaderType) {
+        case ST::Includable:      break;
+        case ST::Vertex:          return "vert";
+        case ST::Fragment:        return "frag";
+        case ST::Geometry:        return "geom";
+        case ST::TessControl:     return "tesc";
+        case ST::TessEvaluation:  return "tese";
+        case ST::Compute:         return "comp";
+        case ST::Task:            return "task";
+        case ST::Mesh:            return "mesh";
+        case ST::RayGeneration:   return "rgen";
+        case ST::RayIntersection: return "rint";
+        case ST::RayAnyHit:       return "rahit";
+        case ST::RayClosestHit:   return "rchit";
+        case ST::RayMiss:         return "rmiss";
+        case ST::RayCallable:     return "rcall";
+        }
+        return "";
+    }
+
+    const char *getSeverityName(MessageSeverity severity)
+    {
+        switch (severity) {
+        case MessageSeverity::Error:   return "error";
+        case MessageSeverity::Warning: return "warning";
+        case MessageSeverity::Info:    break;
+        }
+        return "info";
+    }
+
+    bool isIncludeFileName(const QString &fileName)
+    {
+        const auto extension = FileDialog::getFileExtension(fileName);
+        return (extension == "h" || extension == "hlsli");
+    }
+
+    // the tree below the common directory of the inputs is mirrored
+    QString getCommonDirectory(const QStringList &fileNames)
+    {
+        auto common = QStringList();
+        for (auto i = 0; i < fileNames.size(); ++i) {
+            const auto parts =
+                QFileInfo(fileNames[i]).absolutePath().split(QChar('/'));
+            if (i == 0) {
+                common = parts;
+                continue;
+            }
+            auto count = qsizetype{ };
+            while (count < common.size() && count < parts.size()
+                && common[count] == parts[count])
+                ++count;
+            common.resize(count);
+        }
+        // only the empty part before the root remains
+        if (common.size() == 1 && common.front().isEmpty())
+            return QStringLiteral("/");
+        return common.join(QChar('/'));
+    }
+
+    QByteArray toByteArray(const Spirv &spirv)
+    {
+        return QByteArray(reinterpret_cast<const char *>(spirv.data()),
+            static_cast<qsizetype>(spirv.size() * sizeof(uint32_t)));
+    }
+} // namespace
+
+BatchCompiler::BatchCompiler(Options options) : mOptions(std::move(options))
+{
+}
+
+BatchCompiler::~BatchCompiler() = default;
+
+void BatchCompiler::addJob(Shader::ShaderType shaderType,
+    QList<Shader> shaders, const Session &session)
+{
+    auto job = std::make_unique<Job>();
+    job->shaderType = shaderType;
+    job->shaders = std::move(shaders);
+    job->session = session;
+
+    // SPIR-V can only be generated by a shader compiler
+    if (job->session.shaderCompiler == Session::ShaderCompiler::Driver) {
+        setShaderCompilerSetting(job->session,
+            Session::ShaderCompilerSetting::autoMapBindings, true);
+        setShaderCompilerSetting(job->session,
+            Session::ShaderCompilerSetting::autoMapLocations, true);
+        job->session.shaderCompiler = Session::ShaderCompiler::glslang;
+    }
+    mJobs.push_back(std::move(job));
+}
+
+void BatchCompiler::addSession(const SessionModel &sessionModel)
+{
+    const auto &session = sessionModel.sessionItem();
+    sessionModel.forEachItem([&](const Item &item) {
+        const auto program = castItem<Program>(item);
+        if (!program)
+            return;
+
+        // group shaders of program by stage
+        auto stages = std::map<Shader::ShaderType, QList<Shader>>();
+        for (const auto *child : program->items)
+            if (const auto shader = castItem<Shader>(child))
+                if (shader->shaderType != Shader::ShaderType::Includable) {
+                    // detach copy from session, which is cleared before run
+                    auto copy = *shader;
+                    copy.parent = nullptr;
+                    stages[shader->shaderType].append(copy);
+                }
+
+        for (auto &[shaderType, shaders] : stages)
+            addJob(shaderType, std::move(shaders), session);
+    });
+}
+
+bool BatchCompiler::addFile(const QString &fileName)
+{
+    auto source = QString();
+    if (!Singletons::fileCache().getSource(fileName, &source))
+        return false;
+
+    const auto sourceType =
+        deduceSourceType(SourceType::PlainText, fileName, source);
+    const auto shaderType = getShaderType(sourceType);
+    const auto shaderLanguage = getShaderLanguage(sourceType);
+    if (shaderType == Shader::ShaderType::Includable
+        || shaderLanguage == Session::ShaderLanguage::None)
+        return false;
+
+    auto session = Session{};
+    session.type = Item::Type::Session;
+    session.renderer = Session::Renderer::Vulkan;
+    session.shaderLanguage = shaderLanguage;
+    session.shaderCompiler = Session::ShaderCompiler::glslang;
+
+    auto shader = Shader{};
+    shader.type = Item::Type::Shader;
+    shader.fileName = fileName;
+    shader.shaderType = shaderType;
+    addJob(shaderType, { shader }, session);
+    return true;
+}
+
+void BatchCompiler::addDirectory(const QDir &directory)
+{
+    auto it = QDirIterator(directory.path(), QDir::Files,
+        QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const auto fileName = toNativeCanonicalFilePath(it.next());
+        if (FileDialog::isShaderFileName(fileName)
+            && !isIncludeFileName(fileName))
+            addFile(fileName);
+    }
+}
+
+QString BatchCompiler::getOutputFileName(const Job &job,
+    const QString &extension) const
+{
+    return job.outputBaseName + "." + extension;
+}
+
+bool BatchCompiler::writeFile(Job &job, const QString &extension,
+    const QByteArray &data)
+{
+    // without output directory the shaders are only validated
+    if (mOptions.outputDirectory.isEmpty())
+        return true;
+
+    const auto fileName = getOutputFileName(job, extension);
+    if (job.outputCollides) {
+        job.messages.insert(job.shaders.front().id,
+            MessageType::OutputFileNameCollision, fileName);
+        return false;
+    }
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    auto file = QSaveFile(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()
+        || !file.commit()) {
+        job.messages.insert(job.shaders.front().id,
+            MessageType::WritingFileFailed, fileName);
+        return false;
+    }
+    job.outputFileNames.append(fileName);
+    return true;
+}
+
+void BatchCompiler::runJob(Job &job)
+{
+    auto shaders = QList<const Shader *>();
+    for (const auto &shader : std::as_const(job.shaders))
+        shaders.append(&shader);
+
+    auto shader = ShaderBase(job.shaderType, shaders, job.session);
+    const auto spirv = shader.compileSpirv();
+    job.messages += shader.resetMessages();
+    if (spirv.empty())
+        return;
+
+    job.succeeded = writeFile(job, "spv", toByteArray(spirv));
+
+    const auto itemId = job.shaders.front().id;
+    if (mOptions.generateGLSL) {
+        const auto glsl =
+            ShaderCompiler::generateGLSL(spirv, itemId, job.messages);
+        job.succeeded &= (!glsl.isEmpty() && writeFile(job, "glsl",
+            glsl.toUtf8()));
+    }
+    if (mOptions.generateHLSL) {
+        const auto hlsl =
+            ShaderCompiler::generateHLSL(spirv, itemId, job.messages);
+        job.succeeded &= (!hlsl.isEmpty() && writeFile(job, "hlsl",
+            hlsl.toUtf8()));
+    }
+}
+
+bool BatchCompiler::run()
+{
+    if (!mOptions.outputDirectory.isEmpty())
+        QDir().mkpath(mOptions.outputDirectory);
+
+    // mirror the directories of the inputs, so equally named files of
+    // different directories do not collide
+    auto inputFileNames = QStringList();
+    for (const auto &job : mJobs)
+        inputFileNames.append(job->shaders.front().fileName);
+    const auto commonDirectory = QDir(getCommonDirectory(inputFileNames));
+    const auto getBaseName = [&](const Job &job) {
+        const auto &fileName = job.shaders.front().fileName;
+        const auto relativeFileName =
+            (commonDirectory.path().isEmpty()
+                    ? QFileInfo(fileName).fileName()
+                    : commonDirectory.relativeFilePath(
+                          QFileInfo(fileName).absoluteFilePath()));
+        return QDir::cleanPath(
+            QDir(mOptions.outputDirectory).filePath(relativeFileName));
+    };
+
+    // qualify output filename with stage when the same file is compiled twice
+    auto baseNameCount = QHash<QString, int>();
+    for (const auto &job : mJobs)
+        ++baseNameCount[getBaseName(*job)];
+    auto outputBaseNames = QSet<QString>();
+    for (auto &job : mJobs) {
+        job->outputBaseName = getBaseName(*job);
+        if (baseNameCount[job->outputBaseName] > 1)
+            job->outputBaseName += QStringLiteral(".")
+                + getStageExtension(job->shaderType);
+
+        // same file and stage in several programs would overwrite outputs
+        if (outputBaseNames.contains(job->outputBaseName))
+            job->outputCollides = true;
+        outputBaseNames.insert(job->outputBaseName);
+    }
+
+    // results are stored per job, reports do not depend on scheduling
+    auto pool = QThreadPool();
+    if (mOptions.threadCount > 0)
+        pool.setMaxThreadCount(mOptions.threadCount);
+    for (auto &job : mJobs)
+        pool.start([this, job = job.get()]() { runJob(*job); });
+    pool.waitForDone();
+
+    return std::all_of(mJobs.begin(), mJobs.end(),
+        [](const auto &job) { return job->succeeded; });
+}
+
+QByteArray BatchCompiler::getReport() const
+{
+    auto shaders = JsonArray();
+    auto compiled = 0;
+    for (const auto &job : mJobs) {
+        auto messages = JsonArray();
+        for (const auto &message : job->messages) {
+            auto object = JsonObject();
+            object["severity"] =
+                getSeverityName(getMessageSeverity(*message));
+            object["text"] = getMessageText(*message);
+            if (!message->fileName.isEmpty()) {
+                object["file"] = message->fileName;
+                if (message->line > 0)
+                    object["line"] = message->line;
+            }
+            messages.push_back(std::move(object));
+        }
+
+        auto fileNames = JsonArray();
+        for (const auto &shader : std::as_const(job->shaders))
+            fileNames.push_back(shader.fileName);
+
+        auto outputFileNames = JsonArray();
+        for (const auto &fileName : std::as_const(job->outputFileNames))
+            outputFileNames.push_back(fileName);
+
+        auto object = JsonObject();
+        object["files"] = std::move(fileNames);
+        object["stage"] = getStageExtension(job->shaderType);
+        object["succeeded"] = job->succeeded;
+        object["outputs"] = std::move(outputFileNames);
+        object["messages"] = std::move(messages);
+        shaders.push_back(std::move(object));
+        compiled += (job->succeeded ? 1 : 0);
+    }
+
+    auto report = JsonObject();
+    report["compiled"] = compiled;
+    report["failed"] = static_cast<int>(mJobs.size()) - compiled;
+    report["shaders"] = std::move(shaders);
+    return serializeJson(report).toUtf8();
+}
+
+void BatchCompiler::outputSummaryToStdout() const
+{
+    for (const auto &job : mJobs)
+        std::fprintf(stdout, "%s %s [%s]\n",
+            (job->succeeded ? "OK:    " : "FAILED:"),
+            qUtf8Printable(job->shaders.front().fileName),
+            getStageExtension(job->shaderType));
+    std::fflush(stdout);
+}
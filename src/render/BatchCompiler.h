@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ShaderCompiler.h"
+#include <QDir>
+
+class SessionModel;
+
+// compiles shaders of sessions or loose shader files to SPIR-V in parallel
+class BatchCompiler
+{
+public:
+    struct Options
+    {
+        QString outputDirectory;
+        bool generateGLSL{};
+        bool generateHLSL{};
+        int threadCount{};
+    };
+
+    explicit BatchCompiler(Options options);
+    ~BatchCompiler();
+
+    void addSession(const SessionModel &sessionModel);
+    bool addFile(const QString &fileName);
+    void addDirectory(const QDir &directory);
+    int jobCount() const { return static_cast<int>(mJobs.size()); }
+    bool run();
+    QByteArray getReport() const;
+    void outputSummaryToStdout() const;
+
+private:
+    struct Job;
+
+    void addJob(Shader::ShaderType shaderType, QList<Shader> shaders,
+        const Session &session);
+    void runJob(Job &job);
+    QString getOutputFileName(const Job &job, const QString &extension) const;
+    bool writeFile(Job &job, const QString &extension,
+        const QByteArray &data);
+
+    const Options mOptions;
+    std::vector<std::unique_ptr<Job>> mJobs;
+};
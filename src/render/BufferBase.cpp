@@ -2,12 +2,12 @@
 #include "BufferBase.h"
 #include "FileDialog.h"
 
-BufferBase::BufferBase(int size) : mSize(size)
+BufferBase::BufferBase(qsizetype size) : mSize(size)
 {
     Q_ASSERT(size > 0);
 }
 
-BufferBase::BufferBase(const Buffer &buffer, int size)
+BufferBase::BufferBase(const Buffer &buffer, qsizetype size)
     : mItemId(buffer.id)
     , mFileName(buffer.fileName)
     , mSize(size)
@@ -30,11 +30,27 @@ bool BufferBase::operator==(const BufferBase &rhs) const
 QByteArray &BufferBase::writableData()
 {
     mSystemCopyModified = true;
+    mDataHash.reset();
     if (mData.isNull())
         mData.resize(mSize);
     return mData;
 }
 
+size_t BufferBase::hashData(const void *data) const
+{
+    return qHashBits(data, static_cast<size_t>(mSize));
+}
+
+// cached until the system copy is modified, so that downloaded data
+// only needs to be hashed once to detect modifications
+size_t BufferBase::getDataHash() const
+{
+    Q_ASSERT(mData.size() >= mSize);
+    if (!mDataHash)
+        mDataHash = hashData(mData.constData());
+    return *mDataHash;
+}
+
 bool BufferBase::swap(BufferBase &other)
 {
     if (mSize != other.mSize)
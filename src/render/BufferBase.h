@@ -2,6 +2,7 @@
 
 #include "MessageList.h"
 #include "session/Item.h"
+#include <optional>
 
 class BufferBase
 {
@@ -14,18 +15,21 @@ public:
     QByteArray &writableData();
     const QString &fileName() const { return mFileName; }
     const QSet<ItemId> &usedItems() const { return mUsedItems; }
-    int size() const { return mSize; }
+    qsizetype size() const { return mSize; }
 
 protected:
-    explicit BufferBase(int size);
-    BufferBase(const Buffer &buffer, int size);
+    explicit BufferBase(qsizetype size);
+    BufferBase(const Buffer &buffer, qsizetype size);
     bool swap(BufferBase &other);
+    size_t hashData(const void *data) const;
+    size_t getDataHash() const;
 
     MessagePtrSet mMessages;
     ItemId mItemId{};
     QString mFileName;
-    int mSize{};
+    qsizetype mSize{};
     QByteArray mData;
+    mutable std::optional<size_t> mDataHash;
     QSet<ItemId> mUsedItems;
     bool mSystemCopyModified{};
     bool mDeviceCopyModified{};
@@ -109,6 +109,14 @@ PipelineBase::PipelineBase(ItemId itemId) : mItemId(itemId) { }
 void PipelineBase::setBindings(Bindings &&bindings)
 {
     mBindings = std::move(bindings);
+
+    // uniforms specialized to constants already got their value
+    for (const auto &name : std::as_const(mConstantUniforms))
+        if (auto it = mBindings.uniforms.find(name);
+            it != mBindings.uniforms.end()) {
+            mUsedItems += it->second.bindingItemId;
+            mBindings.uniforms.erase(it);
+        }
 }
 
 std::pair<uint32_t, uint32_t> PipelineBase::getBufferBindingOffsetSize(
@@ -28,6 +28,7 @@ protected:
         ScriptEngine &scriptEngine);
 
     ItemId mItemId{};
+    QSet<QString> mConstantUniforms;
     Bindings mBindings;
     MessagePtrSet mMessages;
     QSet<ItemId> mUsedItems;
@@ -1,4 +1,6 @@
 #include "PrintfBase.h"
+#include <QCache>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QVector>
 #include <array>
@@ -243,6 +245,16 @@ namespace {
             return 0;
         return ((argumentType % 1000) / 100);
     }
+
+    bool mayContainPrintf(const QString &source)
+    {
+        return source.contains(QStringLiteral("printf"));
+    }
+
+    // cost is the number of characters
+    const auto removedPrintfCacheSize = 16 * 1024 * 1024;
+    QMutex gRemovedPrintfMutex;
+    QCache<QString, QString> gRemovedPrintf(removedPrintfCacheSize);
 } // namespace
 
 QString PrintfBase::preambleGLSL(int set, int binding)
@@ -520,6 +532,9 @@ bool PrintfBase::isUsed(Shader::ShaderType stage) const
 QString PrintfBase::patchSource(Shader::ShaderType stage,
     const QString &fileName, const QString &source)
 {
+    if (!mayContainPrintf(source))
+        return source;
+
     const auto sourceWithoutComments = blankComments(source);
     const auto calls = findPrintfCalls(sourceWithoutComments);
     if (calls.isEmpty())
@@ -703,6 +718,12 @@ MessagePtrSet PrintfBase::formatMessages(ItemId callItemId,
 QString RemoveShaderPrintf::patchSource(Shader::ShaderType stage,
     const QString &fileName, const QString &source_)
 {
+    // result only depends on the source, share it between all shaders
+    QMutexLocker lock(&gRemovedPrintfMutex);
+    if (auto cached = gRemovedPrintf.object(source_))
+        return *cached;
+    lock.unlock();
+
     auto source = blankComments(source_);
 
     static const auto regex = QRegularExpression("(\\bprintf\\s*\\()",
@@ -720,5 +741,9 @@ QString RemoveShaderPrintf::patchSource(Shader::ShaderType stage,
         }
         source.remove(match.capturedStart(), pos - match.capturedStart());
     }
+
+    lock.relock();
+    gRemovedPrintf.insert(source_, new QString(source),
+        std::max(source_.size(), qsizetype{ 1 }));
     return source;
 }
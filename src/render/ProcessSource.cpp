@@ -7,6 +7,7 @@
 #include "direct3d/D3DShader.h"
 #include "session/SessionModel.h"
 #include "scripting/ScriptEngine.h"
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
 namespace {
@@ -115,8 +116,21 @@ void ProcessSource::clearMessages()
     mMessages.clear();
 }
 
+void ProcessSource::cancel()
+{
+    ++mRevision;
+}
+
+bool ProcessSource::cancelled() const
+{
+    return (mRevision != mRenderRevision);
+}
+
 void ProcessSource::prepare(bool itemsChanged, EvaluationType)
 {
+    mRenderRevision = mRevision;
+    mRenderFileName = mFileName;
+
     auto shaderType = getShaderType(mSourceType);
     if (shaderType)
         prepareShader(shaderType);
@@ -183,13 +197,16 @@ void ProcessSource::prepareShader(Shader::ShaderType shaderType)
 
 void ProcessSource::render()
 {
-    [[maybe_unused]] auto prevMessages = std::exchange(mMessages, {});
+    auto prevMessages = std::exchange(mMessages, {});
     mOutput.clear();
 
-    if (mValidateSource)
+    auto timer = QElapsedTimer();
+    timer.start();
+
+    if (mValidateSource && !cancelled())
         validate();
 
-    if (!mProcessType.isEmpty()) {
+    if (!mProcessType.isEmpty() && !cancelled()) {
         if (auto string = processString(); !string.isEmpty())
             mOutput = string;
         else if (auto binary = processBinary(); !binary.isEmpty())
@@ -205,6 +222,13 @@ void ProcessSource::render()
     if (mShader && mValidateSource)
         mMessages += mShader->resetMessages();
     mShader.reset();
+
+    // keep previous results, when source changed in the meantime
+    if (cancelled()) {
+        mMessages = std::move(prevMessages);
+        return;
+    }
+    mDurationMs = static_cast<int>(timer.elapsed());
 }
 
 void ProcessSource::validate()
@@ -242,6 +266,18 @@ QString ProcessSource::processString()
     if (mProcessType == "spirv" && mShader)
         return mShader->disassemble();
 
+    if (mProcessType == "spirvOptimized" && mShader)
+        return mShader->disassembleOptimized(false);
+
+    if (mProcessType == "spirvOptimizedSize" && mShader)
+        return mShader->disassembleOptimized(true);
+
+    if (mProcessType == "statistics" && mShader)
+        return mShader->generateStatistics(false);
+
+    if (mProcessType == "statisticsOptimized" && mShader)
+        return mShader->generateStatistics(true);
+
     if (mProcessType == "ast" && mShader)
         return mShader->generateGLSLangAST();
 
@@ -277,5 +313,9 @@ QByteArray ProcessSource::processBinary()
 
 void ProcessSource::finish()
 {
+    if (cancelled())
+        return;
+
     Q_EMIT outputChanged(mOutput);
+    Q_EMIT sourceProcessed(mRenderFileName, mDurationMs);
 }
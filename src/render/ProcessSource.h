@@ -3,6 +3,7 @@
 #include "RenderTask.h"
 #include "MessageList.h"
 #include "session/Item.h"
+#include <atomic>
 
 class ShaderBase;
 #if defined(OPENGL_ENABLED)
@@ -22,9 +23,11 @@ public:
     void setValidateSource(bool validate);
     void setProcessType(QString processType);
     void clearMessages();
+    void cancel();
 
 Q_SIGNALS:
     void outputChanged(QVariant output);
+    void sourceProcessed(QString fileName, int durationMs);
 
 private:
     void prepare(bool itemsChanged, EvaluationType) override;
@@ -34,6 +37,7 @@ private:
     void validate();
     QString processString();
     QByteArray processBinary();
+    bool cancelled() const;
 
     Session mSession;
     std::unique_ptr<ShaderBase> mShader;
@@ -46,4 +50,8 @@ private:
     bool mValidateSource{};
     QString mProcessType{};
     QVariant mOutput;
+    std::atomic<int> mRevision{};
+    int mRenderRevision{};
+    QString mRenderFileName;
+    int mDurationMs{};
 };
@@ -1,8 +1,52 @@
 
 #include "Reflection.h"
+#include <QCache>
+#include <QMutex>
+
+namespace {
+    using ModulePtr = std::shared_ptr<const SpvReflectShaderModule>;
+
+    struct CachedModule
+    {
+        std::vector<uint32_t> spirv;
+        ModulePtr module;
+    };
+
+    // modules are immutable and shared, key is a hash of the SPIR-V words
+    QMutex gCachedModulesMutex;
+    QCache<size_t, CachedModule> gCachedModules(8 * 1024 * 1024);
+
+    size_t getHash(const std::vector<uint32_t> &spirv)
+    {
+        return qHashBits(spirv.data(), spirv.size() * sizeof(uint32_t));
+    }
+
+    ModulePtr getCachedModule(size_t hash, const std::vector<uint32_t> &spirv)
+    {
+        QMutexLocker lock(&gCachedModulesMutex);
+        if (auto cached = gCachedModules.object(hash))
+            if (cached->spirv == spirv)
+                return cached->module;
+        return nullptr;
+    }
+
+    void cacheModule(size_t hash, const std::vector<uint32_t> &spirv,
+        ModulePtr module)
+    {
+        QMutexLocker lock(&gCachedModulesMutex);
+        gCachedModules.insert(hash, new CachedModule{ spirv, module },
+            static_cast<qsizetype>(spirv.size()));
+    }
+} // namespace
 
 Reflection::Reflection(const std::vector<uint32_t> &spirv)
 {
+    const auto hash = getHash(spirv);
+    if (auto cached = getCachedModule(hash, spirv)) {
+        mModule = std::move(cached);
+        return;
+    }
+
     auto module = std::make_unique<SpvReflectShaderModule>();
     if (!spirv.empty()) {
         const auto result = spvReflectCreateShaderModule(
@@ -17,6 +61,7 @@ Reflection::Reflection(const std::vector<uint32_t> &spirv)
                 spvReflectDestroyShaderModule(module);
             delete module;
         });
+    cacheModule(hash, spirv, mModule);
 }
 
 Reflection::~Reflection() = default;
@@ -103,6 +103,7 @@ int getBufferMemberArraySize(const SpvReflectBlockVariable &variable);
 int getBufferMemberArrayStride(const SpvReflectBlockVariable &variable);
 
 QString getJsonString(const Reflection &reflection);
+QString getStatisticsString(const std::vector<uint32_t> &spirv);
 
 inline uint32_t alignUp(uint32_t offset, uint32_t align)
 {
@@ -0,0 +1,256 @@
+#include "Reflection.h"
+#include <QStringList>
+#include <array>
+
+namespace {
+    enum class OpClass {
+        Arithmetic,
+        Bitwise,
+        Relational,
+        Conversion,
+        Composite,
+        Memory,
+        Image,
+        Atomic,
+        Barrier,
+        Derivative,
+        Subgroup,
+        ControlFlow,
+        Function,
+        Extended,
+        Other,
+        COUNT
+    };
+
+    const char *getOpClassName(OpClass opClass)
+    {
+        switch (opClass) {
+        case OpClass::Arithmetic:  return "Arithmetic";
+        case OpClass::Bitwise:     return "Bitwise";
+        case OpClass::Relational:  return "Relational/Logical";
+        case OpClass::Conversion:  return "Conversion";
+        case OpClass::Composite:   return "Composite";
+        case OpClass::Memory:      return "Memory";
+        case OpClass::Image:       return "Image";
+        case OpClass::Atomic:      return "Atomic";
+        case OpClass::Barrier:     return "Barrier";
+        case OpClass::Derivative:  return "Derivative";
+        case OpClass::Subgroup:    return "Subgroup";
+        case OpClass::ControlFlow: return "Control Flow";
+        case OpClass::Function:    return "Function";
+        case OpClass::Extended:    return "Extended";
+        case OpClass::Other:
+        case OpClass::COUNT:       break;
+        }
+        return "Other";
+    }
+
+    OpClass getOpClass(uint32_t op)
+    {
+        const auto inRange = [&](SpvOp first, SpvOp last) {
+            return (op >= static_cast<uint32_t>(first)
+                && op <= static_cast<uint32_t>(last));
+        };
+        if (inRange(SpvOpSNegate, SpvOpSMulExtended))
+            return OpClass::Arithmetic;
+        if (inRange(SpvOpShiftRightLogical, SpvOpBitCount))
+            return OpClass::Bitwise;
+        if (inRange(SpvOpAny, SpvOpFUnordGreaterThanEqual))
+            return OpClass::Relational;
+        if (inRange(SpvOpConvertFToU, SpvOpBitcast))
+            return OpClass::Conversion;
+        if (inRange(SpvOpVectorExtractDynamic, SpvOpTranspose))
+            return OpClass::Composite;
+        if (inRange(SpvOpVariable, SpvOpInBoundsPtrAccessChain))
+            return OpClass::Memory;
+        if (inRange(SpvOpSampledImage, SpvOpImageQuerySamples)
+            || inRange(SpvOpImageSparseSampleImplicitLod,
+                SpvOpImageSparseDrefGather)
+            || op == SpvOpImageSparseRead)
+            return OpClass::Image;
+        if (inRange(SpvOpAtomicLoad, SpvOpAtomicXor))
+            return OpClass::Atomic;
+        if (inRange(SpvOpControlBarrier, SpvOpMemoryBarrier))
+            return OpClass::Barrier;
+        if (inRange(SpvOpDPdx, SpvOpFwidthCoarse))
+            return OpClass::Derivative;
+        if (inRange(SpvOpGroupNonUniformElect, SpvOpGroupNonUniformQuadSwap))
+            return OpClass::Subgroup;
+        if (inRange(SpvOpPhi, SpvOpUnreachable)
+            || op == SpvOpTerminateInvocation
+            || op == SpvOpDemoteToHelperInvocation)
+            return OpClass::ControlFlow;
+        if (inRange(SpvOpFunction, SpvOpFunctionCall))
+            return OpClass::Function;
+        if (op == SpvOpExtInst)
+            return OpClass::Extended;
+        return OpClass::Other;
+    }
+
+    bool isTextureSample(uint32_t op)
+    {
+        switch (op) {
+        case SpvOpImageSampleImplicitLod:
+        case SpvOpImageSampleExplicitLod:
+        case SpvOpImageSampleDrefImplicitLod:
+        case SpvOpImageSampleDrefExplicitLod:
+        case SpvOpImageSampleProjImplicitLod:
+        case SpvOpImageSampleProjExplicitLod:
+        case SpvOpImageSampleProjDrefImplicitLod:
+        case SpvOpImageSampleProjDrefExplicitLod:
+        case SpvOpImageGather:
+        case SpvOpImageDrefGather:
+        case SpvOpImageSparseSampleImplicitLod:
+        case SpvOpImageSparseSampleExplicitLod:
+        case SpvOpImageSparseSampleDrefImplicitLod:
+        case SpvOpImageSparseSampleDrefExplicitLod:
+        case SpvOpImageSparseSampleProjImplicitLod:
+        case SpvOpImageSparseSampleProjExplicitLod:
+        case SpvOpImageSparseSampleProjDrefImplicitLod:
+        case SpvOpImageSparseSampleProjDrefExplicitLod:
+        case SpvOpImageSparseGather:
+        case SpvOpImageSparseDrefGather:               return true;
+        default:                                       return false;
+        }
+    }
+
+    bool isTextureFetch(uint32_t op)
+    {
+        switch (op) {
+        case SpvOpImageFetch:
+        case SpvOpImageRead:
+        case SpvOpImageSparseFetch:
+        case SpvOpImageSparseRead:  return true;
+        default:                    return false;
+        }
+    }
+
+    struct Statistics
+    {
+        uint32_t idBound;
+        int instructions;
+        int functionInstructions;
+        std::array<int, static_cast<int>(OpClass::COUNT)> opClasses;
+        int functions;
+        int functionCalls;
+        int functionVariables;
+        int loops;
+        int branches;
+        int textureSamples;
+        int textureFetches;
+        int imageWrites;
+        int memoryBarriers;
+        int controlBarriers;
+        int atomics;
+        int discards;
+    };
+
+    bool countInstructions(const std::vector<uint32_t> &spirv,
+        Statistics &statistics)
+    {
+        const auto headerSize = size_t{ 5 };
+        if (spirv.size() < headerSize || spirv[0] != SpvMagicNumber)
+            return false;
+
+        statistics.idBound = spirv[3];
+        auto insideFunction = false;
+        for (auto i = headerSize; i < spirv.size();) {
+            const auto wordCount = (spirv[i] >> SpvWordCountShift);
+            const auto op = (spirv[i] & SpvOpCodeMask);
+            if (wordCount == 0 || i + wordCount > spirv.size())
+                return false;
+
+            ++statistics.instructions;
+            if (op == SpvOpFunction) {
+                insideFunction = true;
+                ++statistics.functions;
+            } else if (op == SpvOpFunctionEnd) {
+                insideFunction = false;
+            }
+
+            if (insideFunction) {
+                ++statistics.functionInstructions;
+                ++statistics.opClasses[static_cast<int>(getOpClass(op))];
+
+                switch (op) {
+                case SpvOpFunctionCall: ++statistics.functionCalls; break;
+                case SpvOpLoopMerge:    ++statistics.loops; break;
+                case SpvOpBranchConditional:
+                case SpvOpSwitch:        ++statistics.branches; break;
+                case SpvOpImageWrite:    ++statistics.imageWrites; break;
+                case SpvOpMemoryBarrier: ++statistics.memoryBarriers; break;
+                case SpvOpControlBarrier:
+                    ++statistics.controlBarriers;
+                    break;
+                case SpvOpKill:
+                case SpvOpTerminateInvocation:
+                case SpvOpDemoteToHelperInvocation:
+                    ++statistics.discards;
+                    break;
+                case SpvOpVariable:
+                    if (wordCount > 3
+                        && spirv[i + 3] == SpvStorageClassFunction)
+                        ++statistics.functionVariables;
+                    break;
+                default: break;
+                }
+                if (isTextureSample(op))
+                    ++statistics.textureSamples;
+                if (isTextureFetch(op))
+                    ++statistics.textureFetches;
+                if (getOpClass(op) == OpClass::Atomic)
+                    ++statistics.atomics;
+            }
+            i += wordCount;
+        }
+        return true;
+    }
+
+    int getPushConstantSize(const Reflection &reflection)
+    {
+        auto size = 0u;
+        for (const auto &block : reflection.pushConstantBlocks())
+            size = std::max(size, block.offset + block.size);
+        return static_cast<int>(size);
+    }
+} // namespace
+
+QString getStatisticsString(const std::vector<uint32_t> &spirv)
+{
+    auto statistics = Statistics{};
+    if (!countInstructions(spirv, statistics))
+        return {};
+
+    auto lines = QStringList();
+    const auto add = [&](const QString &name, auto value, int indent = 0) {
+        const QString label = QString(indent, ' ') + name + ':';
+        lines.append(label.leftJustified(24) + QString::number(value));
+    };
+
+    add("Instructions", statistics.instructions);
+    add("In Functions", statistics.functionInstructions, 2);
+    for (auto i = 0; i < static_cast<int>(OpClass::COUNT); ++i)
+        if (const auto count = statistics.opClasses[i])
+            add(getOpClassName(static_cast<OpClass>(i)), count, 4);
+    add("ID Bound", statistics.idBound);
+    add("Function Variables", statistics.functionVariables);
+    add("Functions", statistics.functions);
+    add("Function Calls", statistics.functionCalls);
+    add("Loops", statistics.loops);
+    add("Branches", statistics.branches);
+    add("Texture Samples", statistics.textureSamples);
+    add("Texture Fetches", statistics.textureFetches);
+    add("Image Writes", statistics.imageWrites);
+    add("Atomics", statistics.atomics);
+    add("Memory Barriers", statistics.memoryBarriers);
+    add("Control Barriers", statistics.controlBarriers);
+    add("Discards", statistics.discards);
+
+    if (const auto reflection = Reflection(spirv)) {
+        add("Descriptor Bindings", reflection.descriptorBindings().size());
+        add("Push Constant Bytes", getPushConstantSize(reflection));
+        add("Input Variables", reflection->input_variable_count);
+        add("Output Variables", reflection->output_variable_count);
+    }
+    return lines.join('\n');
+}
@@ -169,14 +169,15 @@ void RenderSessionBase::setNextCommandQueueIndex(size_t index)
     mNextCommandQueueIndex = index;
 }
 
-int RenderSessionBase::getBufferSize(const Buffer &buffer)
+qsizetype RenderSessionBase::getBufferSize(const Buffer &buffer)
 {
-    auto size = 1;
+    auto size = qsizetype{ 1 };
     for (const Item *item : buffer.items) {
         const auto &block = *static_cast<const Block *>(item);
         auto offset = 0, rowCount = 0;
         evaluateBlockProperties(block, &offset, &rowCount);
-        size = std::max(size, offset + rowCount * getBlockStride(block));
+        size = std::max(size,
+            offset + qsizetype{ rowCount } * getBlockStride(block));
     }
     return size;
 }
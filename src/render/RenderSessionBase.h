@@ -2,6 +2,7 @@
 
 #include "RenderTask.h"
 #include "MessageList.h"
+#include "ShaderCompiler.h"
 #include "TextureData.h"
 #include "ShareHandle.h"
 #include "session/SessionModel.h"
@@ -106,7 +107,7 @@ public:
     bool usesKeyboardState() const;
     bool usesViewportSize(const QString &fileName) const;
 
-    int getBufferSize(const Buffer &buffer);
+    qsizetype getBufferSize(const Buffer &buffer);
     void evaluateBlockProperties(const Block &block, int *offset, int *rowCount,
         bool cached = true);
     void evaluateTextureProperties(const Texture &texture, int *width,
@@ -172,6 +173,7 @@ private:
     size_t mNextCommandQueueIndex{};
     QMap<ItemId, GroupIteration> mGroupIterations;
     QMap<ItemId, ScriptValueList> mBindingValues;
+    ShaderCompiler::CompileCache mCompileCache;
 };
 
 template <typename T, typename Item, typename... Args>
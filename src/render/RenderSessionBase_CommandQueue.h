@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderSessionBase.h"
+#include "ShaderCompiler.h"
 #include "Singletons.h"
 #include "SynchronizeLogic.h"
 #include <QStack>
@@ -64,10 +65,17 @@ void RenderSessionBase::buildCommandQueue(CommandQueue &commandQueue) noexcept
         commandQueue.commands.emplace_back(std::move(command));
     };
 
+    // identical shader variants are compiled once until the session resets
+    if (mEvaluationType == EvaluationType::Reset)
+        mCompileCache.clear();
+
     const auto addProgramOnce = [&](ItemId programId) {
-        return addOnce(commandQueue.programs,
+        auto program = addOnce(commandQueue.programs,
             sessionModel.findItem<Program>(programId),
             sessionModel.sessionItem());
+        if (program)
+            program->setCompileCache(&mCompileCache);
+        return program;
     };
 
     const auto addBufferOnce = [&](ItemId bufferId) {
@@ -420,9 +428,12 @@ void RenderSessionBase::finishCommandQueue(CommandQueue &commandQueue) noexcept
     Q_ASSERT(onMainThread());
     auto &synchronizeLogic = Singletons::synchronizeLogic();
 
-    for (auto &[itemId, program] : commandQueue.programs)
+    auto reusedCompilations = 0;
+    for (auto &[itemId, program] : commandQueue.programs) {
         if (program.printf().isUsed())
             mMessages += program.printf().finishDownload(program.itemId());
+        reusedCompilations += program.resetReusedCompilationCount();
+    }
 
     for (auto &[itemId, texture] : commandQueue.textures)
         if (texture.deviceCopyModified())
@@ -434,6 +445,10 @@ void RenderSessionBase::finishCommandQueue(CommandQueue &commandQueue) noexcept
             synchronizeLogic.handleBufferDataChanged(buffer.itemId(),
                 buffer.data());
 
+    if (reusedCompilations)
+        mMessages.insert(MessageType::ShaderCompilationsReused,
+            QString::number(reusedCompilations));
+
     mPrevMessages.clear();
     if (mEvaluationType == EvaluationType::Reset)
         mLastResetMessages = mMessages;
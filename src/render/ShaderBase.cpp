@@ -5,8 +5,11 @@
 #include "FileDialog.h"
 #include "Singletons.h"
 #include "ShaderCompiler.h"
+#include <QCache>
 #include <QFileInfo>
+#include <QMutex>
 #include <QRegularExpression>
+#include <cmath>
 
 namespace {
     bool removeVersion(QString *source, QString *maxVersion)
@@ -67,7 +70,92 @@ namespace {
         source.insert(position, text + QString("#line %1\n").arg(lineNo));
     }
 
-    QString substituteIncludes(QString source, const QString &fileName,
+    // result of the expensive passes over a single file, which only depend
+    // on its content and can therefore be shared between all includers
+    struct ParsedSource
+    {
+        struct Include
+        {
+            qsizetype offset;
+            int lineNo;
+            QString include;
+        };
+        QString source;
+        QString version;
+        QString extensions;
+        QList<Include> includes;
+        bool versionRemoved{};
+        bool usingIncludeExtension{};
+    };
+
+    struct ParsedSourceKey
+    {
+        QString source;
+        bool stripVersion;
+        bool stripExtensions;
+
+        bool operator==(const ParsedSourceKey &) const = default;
+    };
+
+    size_t qHash(const ParsedSourceKey &key, size_t seed)
+    {
+        return qHashMulti(seed, key.source, key.stripVersion,
+            key.stripExtensions);
+    }
+
+    // cost is the number of characters
+    const auto parsedSourcesCacheSize = 32 * 1024 * 1024;
+    QMutex gParsedSourcesMutex;
+    QCache<ParsedSourceKey, ParsedSource> gParsedSources(
+        parsedSourcesCacheSize);
+
+    ParsedSource parseSource(QString source, bool stripVersion,
+        bool stripExtensions)
+    {
+        auto parsed = ParsedSource{};
+        if (stripVersion)
+            parsed.versionRemoved = removeVersion(&source, &parsed.version);
+
+        if (isUsingIncludeExtension(source)) {
+            parsed.usingIncludeExtension = true;
+            parsed.source = std::move(source);
+            return parsed;
+        }
+
+        if (stripExtensions)
+            removeExtensions(&source, &parsed.extensions);
+
+        static const auto regex = QRegularExpression(R"(^\s*#include([^\n]*))",
+            QRegularExpression::MultilineOption);
+        for (auto match = regex.match(source); match.hasMatch();
+            match = regex.match(source, match.capturedStart())) {
+            const auto offset = match.capturedStart();
+            parsed.includes.append({ offset, countLines(source, offset),
+                match.captured(1).trimmed() });
+            source.remove(offset, match.capturedLength());
+        }
+        parsed.source = std::move(source);
+        return parsed;
+    }
+
+    ParsedSource getParsedSource(const QString &source, bool stripVersion,
+        bool stripExtensions)
+    {
+        auto key = ParsedSourceKey{ source, stripVersion, stripExtensions };
+        QMutexLocker lock(&gParsedSourcesMutex);
+        if (auto parsed = gParsedSources.object(key))
+            return *parsed;
+        lock.unlock();
+
+        auto parsed = parseSource(source, stripVersion, stripExtensions);
+
+        lock.relock();
+        gParsedSources.insert(std::move(key), new ParsedSource(parsed),
+            std::max(source.size(), qsizetype{ 1 }));
+        return parsed;
+    }
+
+    QString substituteIncludes(const QString &source, const QString &fileName,
         QStringList *usedFileNames, ItemId itemId, MessagePtrSet &messages,
         const QString &includePaths, QString *maxVersion = nullptr,
         QString *extensions = nullptr, int recursionDepth = 0)
@@ -81,25 +169,28 @@ namespace {
         }
         const auto fileNo =
             (usedFileNames ? usedFileNames->indexOf(fileName) : 0);
-        const auto versionRemoved =
-            (maxVersion ? removeVersion(&source, maxVersion) : false);
-
-        if (isUsingIncludeExtension(source))
-            return source;
-
-        if (extensions)
-            removeExtensions(&source, extensions);
 
-        auto linesInserted = (versionRemoved ? -1 : 0);
-        static const auto regex = QRegularExpression(R"(^\s*#include([^\n]*))",
-            QRegularExpression::MultilineOption);
-        for (auto match = regex.match(source); match.hasMatch();
-            match = regex.match(source)) {
+        const auto parsed = getParsedSource(source, maxVersion != nullptr,
+            extensions != nullptr);
+        if (parsed.versionRemoved)
+            *maxVersion = qMax(*maxVersion, parsed.version);
 
-            const auto lineNo = countLines(source, match.capturedStart());
+        if (parsed.usingIncludeExtension)
+            return parsed.source;
 
-            source.remove(match.capturedStart(), match.capturedLength());
-            auto include = match.captured(1).trimmed();
+        if (extensions)
+            *extensions += parsed.extensions;
+
+        auto result = QString();
+        auto prevOffset = qsizetype{};
+        auto linesInserted = 0;
+        for (const auto &directive : parsed.includes) {
+            result += QStringView(parsed.source)
+                          .mid(prevOffset, directive.offset - prevOffset);
+            prevOffset = directive.offset;
+
+            const auto lineNo = directive.lineNo + linesInserted;
+            auto include = directive.include;
             if ((include.startsWith('<') && include.endsWith('>'))
                 || (include.startsWith('"') && include.endsWith('"'))) {
                 include = include.mid(1, include.size() - 2);
@@ -109,15 +200,15 @@ namespace {
                 auto includeSource = QString();
                 if (Singletons::fileCache().getSource(includeFileName,
                         &includeSource)) {
-                    const auto includableSource =
-                        QString("%1\n#line %2 %3\n")
-                            .arg(substituteIncludes(includeSource,
-                                includeFileName, usedFileNames, itemId,
-                                messages, includePaths, maxVersion, extensions,
-                                recursionDepth))
-                            .arg(lineNo - linesInserted)
-                            .arg(fileNo);
-                    source.insert(match.capturedStart(), includableSource);
+                    const QString includableSource =
+                        substituteIncludes(includeSource, includeFileName,
+                            usedFileNames, itemId, messages, includePaths,
+                            maxVersion, extensions, recursionDepth)
+                        + QStringLiteral("\n#line %1 %2\n")
+                              .arg(directive.lineNo
+                                  + (parsed.versionRemoved ? 1 : 0))
+                              .arg(fileNo);
+                    result += includableSource;
                     linesInserted += countLines(includableSource) - 1;
                 } else {
                     messages.insert(fileName, lineNo,
@@ -128,10 +219,12 @@ namespace {
                     MessageType::InvalidIncludeDirective, fileName);
             }
         }
+        result += QStringView(parsed.source).mid(prevOffset);
+
         return QString("#line %1 %2\n")
-                   .arg(versionRemoved ? 2 : 1)
+                   .arg(parsed.versionRemoved ? 2 : 1)
                    .arg(fileNo ? QString::number(fileNo) : "")
-            + source;
+            + result;
     }
 
     void appendLines(QString &dest, const QString &source)
@@ -202,6 +295,129 @@ namespace {
 
         return "main";
     }
+
+    // uniforms bound to the same literal value at every call of the
+    // program, which can only change on reset
+    QMap<QString, QString> getConstantUniforms(const Item &shader)
+    {
+        const auto program = castItem<Program>(shader.parent);
+        if (!program)
+            return {};
+
+        auto root = static_cast<const Item *>(program);
+        while (root->parent)
+            root = root->parent;
+
+        const auto getLiteralValues = [](const auto &bindings) {
+            auto values = QMap<QString, QString>();
+            for (const auto *binding : bindings) {
+                const auto value = binding->values.value(0).trimmed();
+                auto ok = false;
+                value.toDouble(&ok);
+                if (binding->values.size() == 1 && ok)
+                    values[binding->name] = value;
+            }
+            return values;
+        };
+
+        // resolve bindings visible at each call like the command queue
+        auto scopes = QList<QMap<QString, const Binding *>>{ {} };
+        auto uniforms = QMap<QString, QString>();
+        auto callCount = 0;
+        const auto collect = [&](const Item &item,
+                                 const auto &collect) -> void {
+            if (auto binding = castItem<Binding>(item)) {
+                if (binding->bindingType == Binding::BindingType::Uniform)
+                    scopes.last()[binding->name] = binding;
+            } else if (auto call = castItem<Call>(item)) {
+                if (call->programId == program->id) {
+                    auto visible = QMap<QString, const Binding *>();
+                    for (const auto &scope : std::as_const(scopes))
+                        visible.insert(scope);
+                    const auto values = getLiteralValues(visible);
+                    if (callCount++ == 0) {
+                        uniforms = values;
+                    } else {
+                        for (auto it = uniforms.begin(); it != uniforms.end();)
+                            it = (values.value(it.key()) != it.value()
+                                    ? uniforms.erase(it)
+                                    : std::next(it));
+                    }
+                }
+            }
+
+            const auto group = castItem<Group>(item);
+            const auto scoped =
+                (castItem<ScopeItem>(item) && !(group && group->inlineScope));
+            if (scoped)
+                scopes.append({});
+            for (const auto *child : item.items)
+                collect(*child, collect);
+            if (scoped)
+                scopes.removeLast();
+        };
+        collect(*root, collect);
+        return uniforms;
+    }
+
+    QString formatConstantValue(const QString &type, const QString &value)
+    {
+        auto ok = false;
+        if (type == "bool")
+            return (value.toDouble() != 0 ? "true" : "false");
+        if (type == "int") {
+            value.toLongLong(&ok);
+            return (ok ? value : QString());
+        }
+        if (type == "uint") {
+            value.toULongLong(&ok);
+            return (ok ? QString(value + 'u') : QString());
+        }
+        const auto number = value.toDouble(&ok);
+        if (!ok || !std::isfinite(number))
+            return {};
+        auto result = QString::number(number, 'g', 9);
+        if (!result.contains('.') && !result.contains('e'))
+            result += ".0";
+        return result;
+    }
+
+    // turns declarations of scalar uniforms with a constant value into
+    // specialization constants, which the compiler can fold
+    QString specializeConstantUniforms(QString source,
+        const QMap<QString, QString> &constants)
+    {
+        static const auto regex = QRegularExpression(
+            "^[ \\t]*(layout\\s*\\([^)]*\\)\\s*)?uniform\\s+"
+            "(bool|int|uint|float)\\s+(\\w+)\\s*;",
+            QRegularExpression::MultilineOption);
+        const auto constantIdBase = 1000;
+
+        // replace from back to front, so offsets stay valid
+        auto matches = QList<QRegularExpressionMatch>();
+        for (auto it = regex.globalMatch(source); it.hasNext();)
+            matches.prepend(it.next());
+
+        for (const auto &match : std::as_const(matches)) {
+            const auto name = match.captured(3);
+            const auto it = constants.find(name);
+            if (it == constants.end())
+                continue;
+
+            const auto type = match.captured(2);
+            const auto value = formatConstantValue(type, it.value());
+            if (value.isEmpty())
+                continue;
+
+            const auto constantId = constantIdBase
+                + static_cast<int>(std::distance(constants.begin(), it));
+            source.replace(match.capturedStart(), match.capturedLength(),
+                QStringLiteral("layout(constant_id = %1) const %2 %3 = %4;")
+                    .arg(constantId)
+                    .arg(type, name, value));
+        }
+        return source;
+    }
 } // namespace
 
 QString resolveIncludePath(const QString &currentFile, const QString &relative,
@@ -263,6 +479,12 @@ ShaderBase::ShaderBase(Shader::ShaderType type,
 
     mEntryPoint = getEntryPoint(mEntryPoint, mSession.shaderLanguage, mType,
         mSources.first());
+
+    if (mSession.shaderLanguage == Session::ShaderLanguage::GLSL
+        && mSession.shaderCompiler != Session::ShaderCompiler::Driver
+        && getShaderCompilerBool(mSession,
+            Session::ShaderCompilerSetting::specializeUniforms))
+        mConstantUniforms = getConstantUniforms(*shaders.front());
 }
 
 bool ShaderBase::operator==(const ShaderBase &rhs) const
@@ -273,7 +495,7 @@ bool ShaderBase::operator==(const ShaderBase &rhs) const
 
     const auto tie = [](const ShaderBase &a) {
         return std::tie(a.mType, a.mSources, a.mFileNames, a.mEntryPoint,
-            a.mPreamble, a.mIncludePaths);
+            a.mPreamble, a.mIncludePaths, a.mConstantUniforms);
     };
     return tie(*this) == tie(rhs);
 }
@@ -325,6 +547,10 @@ QStringList ShaderBase::getPatchedSourcesGLSL(PrintfBase &printf,
     for (auto i = 0; i < sources.size(); ++i)
         sources[i] = printf.patchSource(mType, mFileNames[i], sources[i]);
 
+    if (!mConstantUniforms.isEmpty())
+        for (auto &source : sources)
+            source = specializeConstantUniforms(source, mConstantUniforms);
+
     if (printf.isUsed(mType)) {
         const auto explicitBinding =
             (mSession.renderer == Session::Renderer::Vulkan);
@@ -444,6 +670,24 @@ QString ShaderBase::disassemble()
     return ShaderCompiler::disassemble(compileSpirv());
 }
 
+Spirv ShaderBase::optimizeSpirv(const Spirv &spirv, bool optimizeSize)
+{
+    return ShaderCompiler::optimizeSpirv(mSession, spirv, optimizeSize,
+        mItemId, mMessages);
+}
+
+QString ShaderBase::disassembleOptimized(bool optimizeSize)
+{
+    return ShaderCompiler::disassemble(
+        optimizeSpirv(compileSpirv(), optimizeSize));
+}
+
+QString ShaderBase::generateStatistics(bool optimized)
+{
+    const auto spirv = compileSpirv();
+    return getStatisticsString(optimized ? optimizeSpirv(spirv, false) : spirv);
+}
+
 QString ShaderBase::preprocess()
 {
     auto usedFileNames = QStringList();
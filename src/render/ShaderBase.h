@@ -26,11 +26,18 @@ public:
     QString generateGLSL();
     QString generateHLSL();
     QString disassemble();
+    QString disassembleOptimized(bool optimizeSize);
+    QString generateStatistics(bool optimized);
     QString generateGLSLangAST();
+    const QMap<QString, QString> &constantUniforms() const
+    {
+        return mConstantUniforms;
+    }
 
 protected:
     virtual QStringList preprocessorDefinitions() const;
     Spirv compileSpirv(PrintfBase &printf);
+    Spirv optimizeSpirv(const Spirv &spirv, bool optimizeSize);
     QStringList getPatchedSources(PrintfBase &printf,
         QStringList *usedFileNames);
     QStringList getPatchedSourcesGLSL(PrintfBase &printf,
@@ -46,6 +53,7 @@ protected:
     QString mIncludePaths;
     Shader::ShaderType mType{};
     QString mEntryPoint;
+    QMap<QString, QString> mConstantUniforms;
     Session mSession{};
 };
 
@@ -1,18 +1,113 @@
-
 #include "ShaderCompiler.h"
+#include "FileCache.h"
+#include "Singletons.h"
+#include <QCryptographicHash>
+
+namespace {
+    using CompiledStages = ShaderCompiler::CompileCache::Entry;
+
+    QByteArray getCompileKey(const Session &session,
+        const std::vector<ShaderCompiler::Input> &inputs)
+    {
+        auto hash = QCryptographicHash(QCryptographicHash::Sha1);
+        const auto add = [&](const QString &string) {
+            hash.addData(string.toUtf8());
+            hash.addData(QByteArrayView("\0", 1));
+        };
+        add(QString::number(static_cast<int>(session.renderer)));
+        add(session.apiVersion);
+        add(QString::number(static_cast<int>(session.shaderLanguage)));
+        add(QString::number(static_cast<int>(session.shaderCompiler)));
+        const auto &settings = session.shaderCompilerSettings;
+        for (auto it = settings.begin(); it != settings.end(); ++it) {
+            add(it.key());
+            add(it.value().toString());
+        }
+        for (const auto &input : inputs) {
+            add(QString::number(static_cast<int>(input.shaderType)));
+            add(input.entryPoint);
+            add(input.includePaths);
+            for (const auto &fileName : input.fileNames)
+                add(fileName);
+            for (const auto &source : input.sources)
+                add(source);
+        }
+        return hash.result();
+    }
+
+    // files included by the compiler are not part of the key, they are
+    // compared with the file cache, which is updated when files change
+    bool includedFilesUnchanged(const ShaderCompiler::IncludedFiles &files)
+    {
+        auto source = QString();
+        for (const auto &[fileName, data] : files)
+            if (!Singletons::fileCache().getSource(fileName, &source)
+                || source.toUtf8() != data)
+                return false;
+        return true;
+    }
+
+    // replay messages for the items of the program which reuses them
+    ItemId mapItemId(ItemId itemId, const CompiledStages &cached,
+        const std::vector<ShaderCompiler::Input> &inputs,
+        ItemId programItemId)
+    {
+        if (itemId == cached.programItemId)
+            return programItemId;
+        const auto index = cached.inputItemIds.indexOf(itemId);
+        if (index >= 0 && index < static_cast<qsizetype>(inputs.size()))
+            return inputs[index].itemId;
+        return itemId;
+    }
+
+    int getTotalSize(const std::map<Shader::ShaderType, Spirv> &stageSpirv)
+    {
+        auto size = size_t{};
+        for (const auto &[stage, spirv] : stageSpirv)
+            size += spirv.size();
+        return static_cast<int>(size);
+    }
+} // namespace
 
 namespace ShaderCompiler {
 
+    bool CompileCache::find(const QByteArray &key, Entry *entry) const
+    {
+        QMutexLocker lock(&mMutex);
+        if (auto cached = mEntries.object(key)) {
+            *entry = *cached;
+            return true;
+        }
+        return false;
+    }
+
+    void CompileCache::insert(const QByteArray &key, Entry entry)
+    {
+        const auto size = getTotalSize(entry.stageSpirv);
+        QMutexLocker lock(&mMutex);
+        mEntries.insert(key, new Entry(std::move(entry)), size);
+    }
+
+    void CompileCache::clear()
+    {
+        QMutexLocker lock(&mMutex);
+        mEntries.clear();
+    }
+
     extern std::map<Shader::ShaderType, Spirv> compileSpirv_glslang(
         const Session &session, const std::vector<Input> &inputs,
-        ItemId programItemId, MessagePtrSet &messages);
+        ItemId programItemId, MessagePtrSet &messages,
+        IncludedFiles *includedFiles);
 
     extern Spirv compileSpirv_DXC(const Session &session, const Input &input,
         MessagePtrSet &messages);
 
+    extern Spirv compileSpirv_Slang(const Session &session,
+        const Input &input, MessagePtrSet &messages);
+
     std::map<Shader::ShaderType, Spirv> compileSpirv(const Session &session,
         const std::vector<Input> &inputs, ItemId programItemId,
-        MessagePtrSet &messages)
+        MessagePtrSet &messages, CompileCache *cache, bool *reused)
     {
         if (inputs.empty()) {
             messages.insert(programItemId, MessageType::ProgramHasNoShader);
@@ -33,7 +128,57 @@ namespace ShaderCompiler {
             return {};
 #endif
         }
-        return compileSpirv_glslang(session, inputs, programItemId, messages);
+
+        if (session.shaderCompiler == Session::ShaderCompiler::Slang) {
+#if defined(SLANG_ENABLED)
+            auto stageSpirv = std::map<Shader::ShaderType, Spirv>();
+            for (const auto &input : inputs) {
+                auto spirv = compileSpirv_Slang(session, input, messages);
+                if (!spirv.empty())
+                    stageSpirv[input.shaderType] = std::move(spirv);
+            }
+            return stageSpirv;
+#else
+            messages.insert(programItemId, MessageType::ShaderCompilerNotAvailable);
+            return {};
+#endif
+        }
+
+        if (!cache)
+            return compileSpirv_glslang(session, inputs, programItemId,
+                messages, nullptr);
+
+        // validated without holding the lock of the cache
+        const auto key = getCompileKey(session, inputs);
+        if (auto cached = CompiledStages();
+            cache->find(key, &cached)
+            && includedFilesUnchanged(cached.includedFiles)) {
+            for (const auto &message : std::as_const(cached.messages))
+                messages.insert(MessagePtrSet::makeMessage(
+                    mapItemId(message.itemId, cached, inputs, programItemId),
+                    message.type, message.text, message.fileName,
+                    message.line));
+            if (reused)
+                *reused = true;
+            return cached.stageSpirv;
+        }
+
+        auto compiledMessages = MessagePtrSet();
+        auto includedFiles = IncludedFiles();
+        auto stageSpirv = compileSpirv_glslang(session, inputs, programItemId,
+            compiledMessages, &includedFiles);
+        messages += compiledMessages;
+
+        if (stageSpirv.size() == inputs.size()) {
+            auto cached = CompiledStages{ stageSpirv, {}, programItemId, {},
+                std::move(includedFiles) };
+            for (const auto &message : compiledMessages)
+                cached.messages.append(*message);
+            for (const auto &input : inputs)
+                cached.inputItemIds.append(input.itemId);
+            cache->insert(key, std::move(cached));
+        }
+        return stageSpirv;
     }
 
     Spirv compileSpirvVulkanGLSL(Shader::ShaderType shaderType,
@@ -53,7 +198,7 @@ namespace ShaderCompiler {
         };
         auto messages = MessagePtrSet{};
         const auto shaders =
-            compileSpirv_glslang(session, { input }, 0, messages);
+            compileSpirv_glslang(session, { input }, 0, messages, nullptr);
         Q_ASSERT(shaders.size() == 1);
         return (!shaders.empty() ? shaders.begin()->second : Spirv{});
     }
@@ -2,6 +2,8 @@
 
 #include "MessageList.h"
 #include "session/Item.h"
+#include <QCache>
+#include <QMutex>
 
 class Spirv final : public std::vector<uint32_t>
 {
@@ -20,12 +22,40 @@ namespace ShaderCompiler {
         ItemId itemId;
     };
 
+    // files read by the compiler when resolving #include directives
+    using IncludedFiles = QList<std::pair<QString, QByteArray>>;
+
+    // SPIR-V of the shader variants compiled by a render session,
+    // identical variants of different programs are compiled once
+    class CompileCache
+    {
+    public:
+        struct Entry
+        {
+            std::map<Shader::ShaderType, Spirv> stageSpirv;
+            // copies, since messages are listed as long as referenced
+            QList<Message> messages;
+            ItemId programItemId;
+            QList<ItemId> inputItemIds;
+            IncludedFiles includedFiles;
+        };
+
+        bool find(const QByteArray &key, Entry *entry) const;
+        void insert(const QByteArray &key, Entry entry);
+        void clear();
+
+    private:
+        mutable QMutex mMutex;
+        mutable QCache<QByteArray, Entry> mEntries{ 16 * 1024 * 1024 };
+    };
+
     Spirv compileSpirvVulkanGLSL(Shader::ShaderType shaderType,
         const QString &source);
 
     std::map<Shader::ShaderType, Spirv> compileSpirv(const Session &session,
         const std::vector<Input> &inputs, ItemId programItemId,
-        MessagePtrSet &messages);
+        MessagePtrSet &messages, CompileCache *cache = nullptr,
+        bool *reused = nullptr);
 
     QString preprocess(const Session &session, Shader::ShaderType shaderType,
         const QStringList &sources, const QStringList &fileNames,
@@ -33,6 +63,8 @@ namespace ShaderCompiler {
         MessagePtrSet &messages);
 
     QString disassemble(const Spirv &spirv);
+    Spirv optimizeSpirv(const Session &session, const Spirv &spirv,
+        bool optimizeSize, ItemId itemId, MessagePtrSet &messages);
     QString generateGLSL(const Spirv &spirv, ItemId itemId,
         MessagePtrSet &messages);
     QString generateHLSL(const Spirv &spirv, ItemId itemId,
@@ -298,6 +298,7 @@ namespace ShaderCompiler {
         {
         private:
             const QString mIncludePaths;
+            IncludedFiles *mIncludedFiles;
 
             class IncludeResultWithData : public IncludeResult
             {
@@ -315,8 +316,10 @@ namespace ShaderCompiler {
             };
 
         public:
-            explicit Includer(const QString &includePaths)
+            explicit Includer(const QString &includePaths,
+                IncludedFiles *includedFiles = nullptr)
                 : mIncludePaths(includePaths)
+                , mIncludedFiles(includedFiles)
             {
             }
 
@@ -333,8 +336,11 @@ namespace ShaderCompiler {
                 if (!file.open(QFile::ReadOnly | QFile::Text))
                     return nullptr;
 
+                auto data = QTextStream(&file).readAll().toUtf8();
+                if (mIncludedFiles)
+                    mIncludedFiles->append({ fileName, data });
                 return new IncludeResultWithData(fileName.toStdString(),
-                    QTextStream(&file).readAll().toUtf8());
+                    std::move(data));
             }
             void releaseInclude(IncludeResult *result) override
             {
@@ -345,7 +351,8 @@ namespace ShaderCompiler {
 
     std::map<Shader::ShaderType, Spirv> compileSpirv_glslang(
         const Session &session, const std::vector<Input> &inputs,
-        ItemId programItemId, MessagePtrSet &messages)
+        ItemId programItemId, MessagePtrSet &messages,
+        IncludedFiles *includedFiles)
     {
         const auto language = session.shaderLanguage;
         const auto defaultVersion = 100;
@@ -366,7 +373,7 @@ namespace ShaderCompiler {
                 defaultVersion, input.shaderType, input.sources,
                 input.fileNames, input.entryPoint));
 
-            auto includer = Includer(input.includePaths);
+            auto includer = Includer(input.includePaths, includedFiles);
             if (!shader.parse(GetDefaultResources(), defaultVersion,
                     defaultProfile, false, forwardCompatible,
                     static_cast<EShMessages>(requestedMessages), includer)) {
@@ -404,12 +411,18 @@ namespace ShaderCompiler {
             .optimizeSize = false,
         };
 
+        const auto optimize = getShaderCompilerBool(session,
+            Session::ShaderCompilerSetting::optimizeSpirv);
+
         auto stages = std::map<Shader::ShaderType, Spirv>();
         for (auto shaderType : shaderTypes) {
             auto spirv = Spirv();
             glslang::GlslangToSpv(
                 *program.getIntermediate(getStage(shaderType)), spirv,
                 &spvOptions);
+            if (optimize)
+                spirv = optimizeSpirv(session, spirv, false, programItemId,
+                    messages);
             stages.emplace(shaderType, std::move(spirv));
         }
         return stages;
@@ -449,6 +462,35 @@ namespace ShaderCompiler {
         return QString::fromStdString(ss.str());
     }
 
+    Spirv optimizeSpirv(const Session &session, const Spirv &spirv,
+        bool optimizeSize, ItemId itemId, MessagePtrSet &messages)
+    {
+        if (spirv.empty())
+            return { };
+
+        auto optimizer = spvtools::Optimizer(getTargetEnvironment(session));
+        optimizer.SetMessageConsumer([&](spv_message_level_t level,
+                                         const char *, const spv_position_t &,
+                                         const char *message) {
+            if (level <= SPV_MSG_ERROR)
+                messages.insert(itemId, MessageType::ShaderWarning,
+                    QString::fromUtf8(message));
+        });
+        if (optimizeSize) {
+            optimizer.RegisterSizePasses();
+        } else {
+            optimizer.RegisterPerformancePasses();
+        }
+        // keep the valid unoptimized module when a pass fails
+        auto result = Spirv();
+        if (!optimizer.Run(spirv.data(), spirv.size(), &result)) {
+            messages.insert(itemId, MessageType::ShaderWarning,
+                "SPIR-V optimization failed, using unoptimized module");
+            return spirv;
+        }
+        return result;
+    }
+
     QString generateGLSL(const Spirv &spirv, ItemId itemId,
         MessagePtrSet &messages)
     try {
@@ -572,7 +614,8 @@ namespace ShaderCompiler {
 namespace ShaderCompiler {
     std::map<Shader::ShaderType, Spirv> compileSpirv_glslang(
         const Session &session, const std::vector<Input> &inputs,
-        ItemId programItemId, MessagePtrSet &messages)
+        ItemId programItemId, MessagePtrSet &messages,
+        IncludedFiles *includedFiles)
     {
         messages.insert(programItemId, MessageType::ShaderCompilerNotAvailable);
         return { };
@@ -592,6 +635,12 @@ namespace ShaderCompiler {
         return { };
     }
 
+    Spirv optimizeSpirv(const Session &session, const Spirv &spirv,
+        bool optimizeSize, ItemId itemId, MessagePtrSet &messages)
+    {
+        return spirv;
+    }
+
     QString generateGLSL(const Spirv &spirv, ItemId itemId,
         MessagePtrSet &messages)
     {
@@ -1,123 +1,330 @@
-
-#include "Slang.h"
+#include "ShaderCompiler.h"
 
 #include <slang.h>
 #include <slang-com-ptr.h>
 #include <slang-com-helper.h>
 
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
 #include <array>
+#include <functional>
+#include <map>
+#include <set>
+#include <string_view>
 
-void staticInitSlang()
-{
-    Slang::ComPtr<slang::IGlobalSession> globalSession;
-    createGlobalSession(globalSession.writeRef());
-    slang::SessionDesc sessionDesc = {};
+namespace {
+    struct SlangModuleSource
+    {
+        std::string moduleName;
+        std::string path;
+        std::string source;
+    };
 
-    slang::TargetDesc targetDesc = {};
-    targetDesc.format = SLANG_SPIRV;
-    targetDesc.profile = globalSession->findProfile("spirv_1_5");
+    SlangStage getStage(Shader::ShaderType type)
+    {
+        using ST = Shader::ShaderType;
+        switch (type) {
+        case ST::Vertex:          return SLANG_STAGE_VERTEX;
+        case ST::Fragment:        return SLANG_STAGE_FRAGMENT;
+        case ST::Geometry:        return SLANG_STAGE_GEOMETRY;
+        case ST::TessControl:     return SLANG_STAGE_HULL;
+        case ST::TessEvaluation:  return SLANG_STAGE_DOMAIN;
+        case ST::Compute:         return SLANG_STAGE_COMPUTE;
+        case ST::Task:            return SLANG_STAGE_AMPLIFICATION;
+        case ST::Mesh:            return SLANG_STAGE_MESH;
+        case ST::RayGeneration:   return SLANG_STAGE_RAY_GENERATION;
+        case ST::RayIntersection: return SLANG_STAGE_INTERSECTION;
+        case ST::RayAnyHit:       return SLANG_STAGE_ANY_HIT;
+        case ST::RayClosestHit:   return SLANG_STAGE_CLOSEST_HIT;
+        case ST::RayMiss:         return SLANG_STAGE_MISS;
+        case ST::RayCallable:     return SLANG_STAGE_CALLABLE;
+        default:                  return SLANG_STAGE_NONE;
+        }
+    }
 
-    sessionDesc.targets = &targetDesc;
-    sessionDesc.targetCount = 1;
+    void parseLog_Slang(const QString &log, MessagePtrSet &messages)
+    {
+        // FILENAME(100): SEVERITY 30015: TEXT
+        static const auto split = QRegularExpression(
+            "^(.*)" // 1. filename
+            "\\((\\d+)\\):\\s+" // 2. line
+            "([^ :]+)[^:]*:\\s+" // 3. severity
+            "(.*)$"); // 4. text
 
-    std::array<slang::PreprocessorMacroDesc, 2> preprocessorMacroDesc = {
-        slang::PreprocessorMacroDesc{ "BIAS_VALUE", "1138" },
-        slang::PreprocessorMacroDesc{ "OTHER_MACRO", "float" }
-    };
-    sessionDesc.preprocessorMacros = preprocessorMacroDesc.data();
-    sessionDesc.preprocessorMacroCount = preprocessorMacroDesc.size();
+        // source excerpts following each diagnostic are skipped
+        const auto lines = log.split('\n', Qt::SkipEmptyParts);
+        for (const auto &line : lines) {
+            const auto match = split.match(line);
+            if (!match.hasMatch())
+                continue;
+            const auto fileName = match.captured(1);
+            const auto lineNumber = match.captured(2).toInt();
+            const auto severity = match.captured(3);
+            const auto text = match.captured(4);
 
-    std::array<slang::CompilerOptionEntry, 1> options = {
-        { slang::CompilerOptionName::EmitSpirvDirectly,
-            { slang::CompilerOptionValueKind::Int, 1, 0, nullptr, nullptr } }
-    };
-    sessionDesc.compilerOptionEntries = options.data();
-    sessionDesc.compilerOptionEntryCount = options.size();
+            auto messageType = MessageType::ShaderWarning;
+            if (severity.contains("note", Qt::CaseInsensitive))
+                messageType = MessageType::ShaderInfo;
+            if (severity.contains("error", Qt::CaseInsensitive))
+                messageType = MessageType::ShaderError;
 
-    Slang::ComPtr<slang::ISession> session;
-    globalSession->createSession(sessionDesc, session.writeRef());
+            messages.insert(fileName, lineNumber, messageType, text);
+        }
+    }
 
-    Slang::ComPtr<slang::IModule> slangModule;
+    // creating a global session loads the core module, which is expensive
+    slang::IGlobalSession &getGlobalSession()
     {
-        Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-        const char *source = R"slang(
-              
-StructuredBuffer<float> buffer0;
-StructuredBuffer<float> buffer1;
-RWStructuredBuffer<float> result;
-
-[shader("compute")]
-[numthreads(1,1,1)]
-void computeMain(uint3 threadId : SV_DispatchThreadID)
-{
-    uint index = threadId.x;
-    result[index] = buffer0[index] + buffer1[index];
-}  
-              )slang";
-
-        const char *moduleName = "shortest";
-        const char *modulePath = "shortest.slang";
-        slangModule = session->loadModuleFromSourceString(moduleName,
-            modulePath, source, diagnosticsBlob.writeRef());
-        //diagnoseIfNeeded(diagnosticsBlob);
-        //if (!slangModule) {
-        //    return -1;
-        //}
+        thread_local auto globalSession = []() {
+            Slang::ComPtr<slang::IGlobalSession> globalSession;
+            slang::createGlobalSession(globalSession.writeRef());
+            return globalSession;
+        }();
+        return *globalSession;
     }
 
-    Slang::ComPtr<slang::IEntryPoint> entryPoint;
+    Slang::ComPtr<slang::ISession> createSession()
     {
-        Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-        slangModule->findEntryPointByName("computeMain", entryPoint.writeRef());
-        //if (!entryPoint) {
-        //    std::cout << "Error getting entry point" << std::endl;
-        //    return -1;
-        //}
-    }
+        auto &globalSession = getGlobalSession();
 
-    std::array<slang::IComponentType *, 2> componentTypes = { slangModule,
-        entryPoint };
+        slang::TargetDesc targetDesc = {};
+        targetDesc.format = SLANG_SPIRV;
+        targetDesc.profile = globalSession.findProfile("spirv_1_5");
 
-    Slang::ComPtr<slang::IComponentType> composedProgram;
+        slang::SessionDesc sessionDesc = {};
+        sessionDesc.targets = &targetDesc;
+        sessionDesc.targetCount = 1;
+
+        std::array<slang::CompilerOptionEntry, 1> options = { {
+            { slang::CompilerOptionName::EmitSpirvDirectly,
+                { slang::CompilerOptionValueKind::Int, 1, 0, nullptr,
+                    nullptr } },
+        } };
+        sessionDesc.compilerOptionEntries = options.data();
+        sessionDesc.compilerOptionEntryCount = options.size();
+
+        Slang::ComPtr<slang::ISession> session;
+        globalSession.createSession(sessionDesc, session.writeRef());
+        return session;
+    }
+
+    void appendDiagnostics(std::string &diagnostics, slang::IBlob *blob)
     {
-        Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-        SlangResult result = session->createCompositeComponentType(
-            componentTypes.data(), componentTypes.size(),
-            composedProgram.writeRef(), diagnosticsBlob.writeRef());
-        //diagnoseIfNeeded(diagnosticsBlob);
-        //SLANG_RETURN_ON_FAIL(result);
+        if (blob)
+            diagnostics.append(
+                static_cast<const char *>(blob->getBufferPointer()),
+                blob->getBufferSize());
     }
 
-    Slang::ComPtr<slang::IComponentType> linkedProgram;
+    size_t getFileHash(const std::string &path)
     {
-        Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-        SlangResult result = composedProgram->link(linkedProgram.writeRef(),
-            diagnosticsBlob.writeRef());
-        //diagnoseIfNeeded(diagnosticsBlob);
-        //SLANG_RETURN_ON_FAIL(result);
+        auto file = QFile(QString::fromStdString(path));
+        if (!file.open(QFile::ReadOnly))
+            return 0;
+        const auto data = file.readAll();
+        return std::hash<std::string_view>{}(
+            std::string_view(data.constData(), data.size()));
     }
 
-    if (true) {
+    // a session keeps modules by name and never reloads them. shaders are
+    // loaded with their source hash in the name, so only the changed shader
+    // is replaced. imports are resolved by name, so a changed imported
+    // module or file still requires a new session
+    class ModuleCache
+    {
+    public:
+        void update(const std::vector<SlangModuleSource> &modules)
+        {
+            mSourcePaths.clear();
+            for (const auto &module : modules)
+                mSourcePaths.insert(module.path);
+
+            auto valid = (mStaleModuleCount <= MaxStaleModules);
+            for (auto i = size_t{ }; valid && i + 1 < modules.size(); ++i) {
+                const auto it = mModules.find(modules[i].moduleName);
+                valid = (it == mModules.end()
+                    || it->second.hash == getHash(modules[i]));
+            }
+            for (auto it = mImportedFiles.begin();
+                 valid && it != mImportedFiles.end(); ++it)
+                valid = (getFileHash(it->first) == it->second);
+
+            if (!valid) {
+                mModules.clear();
+                mShaderModuleNames.clear();
+                mImportedFiles.clear();
+                mStaleModuleCount = 0;
+                mSession = nullptr;
+            }
+            if (!mSession)
+                mSession = createSession();
+        }
 
-        Slang::ComPtr<slang::IBlob> spirvCode;
+        slang::IModule *loadModule(const SlangModuleSource &module,
+            bool isShader, std::string &diagnostics)
         {
+            const auto hash = getHash(module);
+            const auto name = (isShader
+                    ? module.moduleName + "_" + std::to_string(hash)
+                    : module.moduleName);
+            const auto it = mModules.find(name);
+            if (it != mModules.end())
+                return it->second.module;
+
             Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-            SlangResult result =
-                linkedProgram->getEntryPointCode(0, // entryPointIndex
-                    0, // targetIndex
-                    spirvCode.writeRef(), diagnosticsBlob.writeRef());
-            //diagnoseIfNeeded(diagnosticsBlob);
-            //SLANG_RETURN_ON_FAIL(result);
+            auto slangModule = mSession->loadModuleFromSourceString(
+                name.c_str(), module.path.c_str(), module.source.c_str(),
+                diagnosticsBlob.writeRef());
+            appendDiagnostics(diagnostics, diagnosticsBlob);
+            if (!slangModule)
+                return nullptr;
+
+            // evict the previous version of the shader
+            if (isShader) {
+                auto &previous = mShaderModuleNames[module.moduleName];
+                if (!previous.empty()) {
+                    mModules.erase(previous);
+                    ++mStaleModuleCount;
+                }
+                previous = name;
+            }
+            mModules[name] = { hash, slangModule };
+
+            // files the module imported from disk
+            for (auto i = 0; i < slangModule->getDependencyFileCount(); ++i) {
+                const auto path =
+                    std::string(slangModule->getDependencyFilePath(i));
+                if (!mSourcePaths.contains(path)
+                    && !mImportedFiles.contains(path))
+                    mImportedFiles[path] = getFileHash(path);
+            }
+            return slangModule;
         }
 
-    } else {
-        Slang::ComPtr<slang::IBlob> spirvCode;
+        slang::ISession &session() { return *mSession; }
+
+    private:
+        // replaced shaders stay in the session until it is recreated
+        static constexpr auto MaxStaleModules = 64;
+
+        static size_t getHash(const SlangModuleSource &module)
         {
-            Slang::ComPtr<slang::IBlob> diagnosticsBlob;
-            SlangResult result = linkedProgram->getTargetCode(0, // targetIndex
-                spirvCode.writeRef(), diagnosticsBlob.writeRef());
-            //diagnoseIfNeeded(diagnosticsBlob);
-            //SLANG_RETURN_ON_FAIL(result);
+            return std::hash<std::string>{}(module.source);
+        }
+
+        struct CachedModule
+        {
+            size_t hash;
+            slang::IModule *module;
+        };
+        Slang::ComPtr<slang::ISession> mSession;
+        std::map<std::string, CachedModule> mModules;
+        std::map<std::string, std::string> mShaderModuleNames;
+        std::map<std::string, size_t> mImportedFiles;
+        std::set<std::string> mSourcePaths;
+        int mStaleModuleCount{ };
+    };
+
+    ModuleCache &getModuleCache()
+    {
+        thread_local auto moduleCache = ModuleCache();
+        return moduleCache;
+    }
+} // namespace
+
+namespace ShaderCompiler {
+
+    Spirv compileSpirv_Slang(const Session &session, const Input &input,
+        MessagePtrSet &messages)
+    {
+        const auto stage = getStage(input.shaderType);
+        if (stage == SLANG_STAGE_NONE) {
+            messages.insert(input.itemId, MessageType::UnsupportedShaderType);
+            return {};
         }
+
+        // every source is loaded as a module, the last one is the shader
+        auto modules = std::vector<SlangModuleSource>();
+        for (auto i = 0; i < input.sources.size(); ++i)
+            modules.push_back({
+                QFileInfo(input.fileNames[i]).completeBaseName().toStdString(),
+                input.fileNames[i].toStdString(),
+                input.sources[i].toStdString(),
+            });
+
+        auto diagnostics = std::string();
+        const auto spirv = [&]() -> Spirv {
+            auto &moduleCache = getModuleCache();
+            moduleCache.update(modules);
+            auto componentTypes = std::vector<slang::IComponentType *>();
+            auto slangModule = static_cast<slang::IModule *>(nullptr);
+            for (const auto &module : modules) {
+                slangModule = moduleCache.loadModule(module,
+                    &module == &modules.back(), diagnostics);
+                if (!slangModule)
+                    return {};
+                componentTypes.push_back(slangModule);
+            }
+
+            // entry points without [shader] attribute are checked for stage
+            Slang::ComPtr<slang::IEntryPoint> entryPoint;
+            {
+                Slang::ComPtr<slang::IBlob> diagnosticsBlob;
+                slangModule->findAndCheckEntryPoint(
+                    input.entryPoint.toUtf8().constData(), stage,
+                    entryPoint.writeRef(), diagnosticsBlob.writeRef());
+                appendDiagnostics(diagnostics, diagnosticsBlob);
+                if (!entryPoint)
+                    return {};
+            }
+            componentTypes.push_back(entryPoint);
+
+            Slang::ComPtr<slang::IComponentType> composedProgram;
+            {
+                Slang::ComPtr<slang::IBlob> diagnosticsBlob;
+                const auto result =
+                    moduleCache.session().createCompositeComponentType(
+                        componentTypes.data(), componentTypes.size(),
+                        composedProgram.writeRef(),
+                        diagnosticsBlob.writeRef());
+                appendDiagnostics(diagnostics, diagnosticsBlob);
+                if (SLANG_FAILED(result))
+                    return {};
+            }
+
+            Slang::ComPtr<slang::IComponentType> linkedProgram;
+            {
+                Slang::ComPtr<slang::IBlob> diagnosticsBlob;
+                const auto result = composedProgram->link(
+                    linkedProgram.writeRef(), diagnosticsBlob.writeRef());
+                appendDiagnostics(diagnostics, diagnosticsBlob);
+                if (SLANG_FAILED(result))
+                    return {};
+            }
+
+            Slang::ComPtr<slang::IBlob> spirvCode;
+            {
+                Slang::ComPtr<slang::IBlob> diagnosticsBlob;
+                const auto result = linkedProgram->getEntryPointCode(0, 0,
+                    spirvCode.writeRef(), diagnosticsBlob.writeRef());
+                appendDiagnostics(diagnostics, diagnosticsBlob);
+                if (SLANG_FAILED(result))
+                    return {};
+            }
+
+            const auto begin =
+                static_cast<const uint32_t *>(spirvCode->getBufferPointer());
+            return Spirv(begin,
+                begin + spirvCode->getBufferSize() / sizeof(uint32_t));
+        }();
+
+        parseLog_Slang(QString::fromStdString(diagnostics), messages);
+        if (spirv.empty() && diagnostics.empty())
+            messages.insert(input.itemId, MessageType::ShaderError,
+                QStringLiteral("entry point '%1' not found")
+                    .arg(input.entryPoint));
+        return spirv;
     }
-}
\ No newline at end of file
+
+} // namespace ShaderCompiler
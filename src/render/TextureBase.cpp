@@ -5,6 +5,7 @@
 #include "Singletons.h"
 #include "RenderSessionBase.h"
 #include <cmath>
+#include <limits>
 
 Texture::Format toPowerOfTwoByteFormat(Texture::Format format)
 {
@@ -87,7 +88,6 @@ TextureBase::TextureBase(const Buffer &buffer, Texture::Format format,
     : mItemId(buffer.id)
     , mTarget(Texture::Target::TargetBuffer)
     , mFormat(format)
-    , mWidth(renderSession.getBufferSize(buffer))
     , mHeight(1)
     , mDepth(1)
     , mLayers(1)
@@ -95,6 +95,15 @@ TextureBase::TextureBase(const Buffer &buffer, Texture::Format format,
     , mKind()
 {
     mUsedItems += buffer.id;
+
+    // the width is an int, larger buffers are not attached
+    const auto size = renderSession.getBufferSize(buffer);
+    if (size > std::numeric_limits<int>::max()) {
+        mMessages.insert(mItemId, MessageType::BufferTooLargeForTexture,
+            QString::number(size));
+        return;
+    }
+    mWidth = static_cast<int>(size);
 }
 
 TextureBase::TextureBase(TextureData data, int samples)
@@ -155,8 +164,22 @@ void TextureBase::reload(bool forWriting)
         if (!mFileData.isSharedWith(fileData)) {
             mFileData = fileData;
 
-            const auto data = fileData.convert(mFormat, mWidth, mHeight, mDepth,
-                mLayers, mRowOrder);
+            auto data = TextureData{ };
+            if (getTextureDataType(mFormat) == TextureDataType::Compressed
+                && !fileData.isCompressed()) {
+                // block compress the resized source on the CPU
+                const auto source = fileData.convert(fileData.format(),
+                    mWidth, mHeight, mDepth, mLayers, mRowOrder);
+                auto psnr = 0.0;
+                if (!source.isNull()
+                    && Singletons::fileCache().getCompressedTexture(mFileName,
+                        source, mFormat, &data, &psnr))
+                    mMessages.insert(mItemId, MessageType::TextureCompressed,
+                        QString::number(psnr, 'f', 2));
+            } else {
+                data = fileData.convert(mFormat, mWidth, mHeight, mDepth,
+                    mLayers, mRowOrder);
+            }
             if (!data.isNull()) {
                 if (!mData.isSharedWith(data)) {
                     mSystemCopyModified = true;
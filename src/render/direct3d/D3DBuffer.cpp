@@ -8,7 +8,7 @@ D3DBuffer::D3DBuffer(const Buffer &buffer, D3DRenderSession &renderSession)
     mUsedItems += buffer.id;
 }
 
-D3DBuffer::D3DBuffer(int size) : BufferBase(size) { }
+D3DBuffer::D3DBuffer(qsizetype size) : BufferBase(size) { }
 
 void D3DBuffer::clear(D3DContext &context)
 {
@@ -98,7 +98,10 @@ void D3DBuffer::reload()
     if (mSize > mData.size())
         mData.append(QByteArray(mSize - mData.size(), 0));
 
-    mSystemCopyModified |= !mData.isSharedWith(prevData);
+    if (!mData.isSharedWith(prevData)) {
+        mSystemCopyModified = true;
+        mDataHash.reset();
+    }
 }
 
 void D3DBuffer::createBuffer(D3DContext &context)
@@ -175,9 +178,12 @@ bool D3DBuffer::finishDownload()
         auto mappedData = std::add_pointer_t<void>{};
         AssertIfFailed(mDownloadBuffer->Map(0, nullptr, &mappedData));
         Q_ASSERT(mData.size() >= mSize);
-        if (!mCheckModification
-            || std::memcmp(mData.data(), mappedData, mSize) != 0) {
+        const auto hash = (mCheckModification
+                ? std::optional<size_t>(hashData(mappedData))
+                : std::nullopt);
+        if (!hash || *hash != getDataHash()) {
             std::memcpy(mData.data(), mappedData, mSize);
+            mDataHash = hash;
             modified = true;
         }
         mDownloadBuffer->Unmap(0, nullptr);
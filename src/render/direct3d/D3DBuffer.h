@@ -8,7 +8,7 @@ class D3DBuffer : public BufferBase
 {
 public:
     D3DBuffer(const Buffer &buffer, D3DRenderSession &renderSession);
-    explicit D3DBuffer(int size);
+    explicit D3DBuffer(qsizetype size);
 
     ID3D12Resource *resource() { return mResource.Get(); }
     UINT alignedSize() const { return static_cast<UINT>((mSize + 255) & ~255); }
@@ -22,6 +22,8 @@ public:
     const SpvReflectDescriptorBinding *getSpirvDescriptorBinding(
         Shader::ShaderType stage, const QString &name) const;
     D3DPrintf &printf() { return mPrintf; }
+    void setCompileCache(ShaderCompiler::CompileCache *) { }
+    int resetReusedCompilationCount() { return 0; }
     bool setupPipelineState(D3D12_GRAPHICS_PIPELINE_STATE_DESC &state);
     bool setupPipelineState(D3D12_COMPUTE_PIPELINE_STATE_DESC &state);
 
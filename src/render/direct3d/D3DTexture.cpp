@@ -484,8 +484,8 @@ void D3DTexture::upload(D3DContext &context)
         for (auto layer = 0; layer < layers(); ++layer) {
             subresourceData.push_back({
                 .pData = mData.getData(level, layer, 0),
-                .RowPitch = mData.getLevelStride(level),
-                .SlicePitch = mData.getImageSize(level),
+                .RowPitch = static_cast<LONG_PTR>(mData.getLevelStride(level)),
+                .SlicePitch = static_cast<LONG_PTR>(mData.getImageSize(level)),
             });
         }
 
@@ -1,7 +1,7 @@
 #include "GLBuffer.h"
 #include "Singletons.h"
 
-GLBuffer::GLBuffer(int size) : BufferBase(size) { }
+GLBuffer::GLBuffer(qsizetype size) : BufferBase(size) { }
 
 GLBuffer::GLBuffer(const Buffer &buffer, GLRenderSession &renderSession)
     : BufferBase(buffer, renderSession.getBufferSize(buffer))
@@ -21,6 +21,7 @@ QByteArray &GLBuffer::getWriteableData()
     Q_ASSERT(mFileName.isEmpty());
     mData.resize(mSize);
     mSystemCopyModified = true;
+    mDataHash.reset();
     return mData;
 }
 
@@ -69,7 +70,7 @@ GLuint GLBuffer::getReadWriteBufferId(GLContext &gl)
 }
 
 void GLBuffer::bindIndexedRange(GLContext &gl, GLenum target, int index,
-    int offset, int size, bool readonly)
+    GLintptr offset, GLsizeiptr size, bool readonly)
 {
     const auto bufferObject =
         (readonly ? getReadOnlyBufferId(gl) : getReadWriteBufferId(gl));
@@ -102,7 +103,10 @@ void GLBuffer::reload()
     if (mSize > mData.size())
         mData.append(QByteArray(mSize - mData.size(), 0));
 
-    mSystemCopyModified |= !mData.isSharedWith(prevData);
+    if (!mData.isSharedWith(prevData)) {
+        mSystemCopyModified = true;
+        mDataHash.reset();
+    }
 }
 
 void GLBuffer::createBuffer(GLContext &gl)
@@ -142,20 +146,19 @@ void GLBuffer::beginDownload(GLContext &gl, bool checkModification)
     if (!mDeviceCopyModified)
         return;
 
-    auto prevData = QByteArray();
-    if (checkModification)
-        prevData = mData;
+    const auto prevHash = (checkModification
+            ? std::optional<size_t>(getDataHash())
+            : std::nullopt);
 
     gl.glBindBuffer(GL_ARRAY_BUFFER, mBufferObject);
     gl.glGetBufferSubData(GL_ARRAY_BUFFER, 0, mSize, mData.data());
     gl.glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
 
     mSystemCopyModified = mDeviceCopyModified = false;
+    mDataHash.reset();
 
-    if (checkModification && prevData == mData) {
-        mData = prevData;
+    if (prevHash && getDataHash() == *prevHash)
         return;
-    }
     mDownloaded = true;
 }
 
@@ -7,7 +7,7 @@
 class GLBuffer : public BufferBase
 {
 public:
-    explicit GLBuffer(int size);
+    explicit GLBuffer(qsizetype size);
     GLBuffer(const Buffer &buffer, GLRenderSession &renderSession);
 
     QByteArray &getWriteableData();
@@ -17,8 +17,8 @@ public:
     GLuint getReadOnlyBufferId(GLContext &gl);
     GLuint getReadWriteBufferId(GLContext &gl);
     void bindReadOnly(GLContext &gl, GLenum target);
-    void bindIndexedRange(GLContext &gl, GLenum target, int index, int offset,
-        int size, bool readonly);
+    void bindIndexedRange(GLContext &gl, GLenum target, int index,
+        GLintptr offset, GLsizeiptr size, bool readonly);
     void unbind(GLContext &gl, GLenum target);
     void beginDownload(GLContext &context, bool checkModification);
     bool finishDownload();
@@ -72,8 +72,12 @@ void GLCall::setProgram(GLProgram *program)
     if (mKind.draw || mKind.compute)
         mProgram = program;
 
-    if (mProgram)
+    if (mProgram) {
         mUsedItems += mProgram->usedItems();
+        for (const auto &shader : mProgram->shaders())
+            for (const auto &name : shader.constantUniforms().keys())
+                mConstantUniforms += name;
+    }
 }
 
 void GLCall::setTarget(GLTarget *target)
@@ -33,6 +33,18 @@ bool GLContext::initialize(QOpenGLContext *context)
         return false;
 
     mContext = context;
+
+    // let driver compile shaders in background threads
+    if (hasExtension("GL_KHR_parallel_shader_compile")) {
+        void (*glMaxShaderCompilerThreadsKHR)(GLuint);
+        glMaxShaderCompilerThreadsKHR =
+            getProcAddress<decltype(glMaxShaderCompilerThreadsKHR)>(
+                "glMaxShaderCompilerThreadsKHR");
+        if (glMaxShaderCompilerThreadsKHR) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            mParallelShaderCompile = true;
+        }
+    }
     return true;
 }
 
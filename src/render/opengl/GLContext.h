@@ -24,6 +24,7 @@ public:
     QOpenGLVertexArrayObject::Binder bindVertexArrayObject();
     QString getLastGLError();
     bool hasExtension(const char *name) { return mContext->hasExtension(name); }
+    bool hasParallelShaderCompile() const { return mParallelShaderCompile; }
 
     template <typename T>
     T getProcAddress(const char *name)
@@ -38,4 +39,5 @@ private:
     std::unique_ptr<QOpenGLDebugLogger> mDebugLogger;
     std::unique_ptr<QOpenGLVertexArrayObject> mVertexArrayObject;
     QString mLastGLError;
+    bool mParallelShaderCompile{};
 };
@@ -68,6 +68,23 @@ bool GLProgram::validate(GLContext &gl)
     return true;
 }
 
+void GLProgram::submit(GLContext &gl)
+{
+    if (mProgramObject || mPendingProgramObject || mFailed
+        || mShaders.empty()
+        || mSession.shaderCompiler != Session::ShaderCompiler::Driver)
+        return;
+
+    // issue compilation and linking without waiting for the results,
+    // which are collected when the program is linked
+    for (auto &shader : mShaders)
+        if (!shader.submit(gl, mPrintf))
+            return;
+
+    mPendingProgramObject = createProgram(gl);
+    gl.glLinkProgram(mPendingProgramObject);
+}
+
 bool GLProgram::link(GLContext &context)
 {
     if (mProgramObject)
@@ -76,6 +93,7 @@ bool GLProgram::link(GLContext &context)
         return false;
 
     if (!compileShaders(context, mPrintf) || !linkProgram(context)) {
+        mPendingProgramObject.reset();
         mFailed = true;
         return false;
     }
@@ -95,8 +113,10 @@ bool GLProgram::compileShaders(GLContext &gl, PrintfBase &printf)
         for (auto &shader : mShaders)
             inputs.push_back(shader.getShaderCompilerInput(printf));
 
-        mStageSpirv =
-            ShaderCompiler::compileSpirv(mSession, inputs, mItemId, mMessages);
+        auto reused = false;
+        mStageSpirv = ShaderCompiler::compileSpirv(mSession, inputs, mItemId,
+            mMessages, mCompileCache, &reused);
+        mReusedCompilationCount += (reused ? 1 : 0);
         for (auto &shader : mShaders)
             if (!shader.specialize(gl, mStageSpirv[shader.type()]))
                 return false;
@@ -111,15 +131,12 @@ bool GLProgram::linkProgram(GLContext &gl)
         return false;
     }
 
-    auto freeProgram = [](GLContext &gl, GLuint program) {
-        gl.glDeleteProgram(program);
-    };
-
-    auto program = GLObject(&gl, gl.glCreateProgram(), freeProgram);
-    for (auto &shader : mShaders)
-        gl.glAttachShader(program, shader.shaderObject());
+    auto program = std::move(mPendingProgramObject);
+    if (!program) {
+        program = createProgram(gl);
+        gl.glLinkProgram(program);
+    }
 
-    gl.glLinkProgram(program);
     auto status = GLint{};
     auto length = GLint{};
     gl.glGetProgramiv(program, GL_LINK_STATUS, &status);
@@ -139,6 +156,18 @@ bool GLProgram::linkProgram(GLContext &gl)
     return true;
 }
 
+GLObject GLProgram::createProgram(GLContext &gl)
+{
+    auto freeProgram = [](GLContext &gl, GLuint program) {
+        gl.glDeleteProgram(program);
+    };
+
+    auto program = GLObject(&gl, gl.glCreateProgram(), freeProgram);
+    for (auto &shader : mShaders)
+        gl.glAttachShader(program, shader.shaderObject());
+    return program;
+}
+
 bool GLProgram::bind(GLContext &gl)
 {
     if (!link(gl))
@@ -34,6 +34,7 @@ public:
     bool operator==(const GLProgram &rhs) const;
 
     bool validate(GLContext &gl);
+    void submit(GLContext &gl);
     bool link(GLContext &context);
     bool bind(GLContext &gl);
     void unbind(GLContext &gl);
@@ -52,11 +53,20 @@ public:
     }
     GLPrintf &printf() { return mPrintf; }
     MessagePtrSet resetMessages();
+    void setCompileCache(ShaderCompiler::CompileCache *cache)
+    {
+        mCompileCache = cache;
+    }
+    int resetReusedCompilationCount()
+    {
+        return std::exchange(mReusedCompilationCount, 0);
+    }
     QString tryGetProgramBinary(GLContext &gl);
 
 private:
     bool compileShaders(GLContext &gl, PrintfBase &printf);
     bool linkProgram(GLContext &gl);
+    GLObject createProgram(GLContext &gl);
     void generateReflectionFromProgram(GLContext &gl, GLuint program,
         bool generateGlobalUniformBlockBinding);
     void enumerateSubroutines(GLContext &gl, GLuint program);
@@ -68,8 +78,11 @@ private:
     std::vector<GLShader> mShaders;
     std::vector<GLShader> mIncludableShaders;
     GLObject mProgramObject;
+    GLObject mPendingProgramObject;
     Reflection mReflection;
     bool mFailed{};
+    ShaderCompiler::CompileCache *mCompileCache{};
+    int mReusedCompilationCount{};
     GLPrintf mPrintf;
     std::map<QString, GLBuffer> mDynamicUniformBuffers;
     std::vector<Uniform> mUniforms;
@@ -86,6 +86,21 @@ void GLRenderSession::render()
     gl.glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
     gl.glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
 
+    // let driver compile and link all programs which cannot be reused
+    // in parallel, results are collected when a program is first bound
+    if (gl.hasParallelShaderCompile()) {
+        const auto canReuse = [&](ItemId itemId, const GLProgram &program) {
+            if (!mPrevCommandQueue)
+                return false;
+            const auto it = mPrevCommandQueue->programs.find(itemId);
+            return (it != mPrevCommandQueue->programs.end()
+                && program == it->second);
+        };
+        for (auto &[itemId, program] : mCommandQueue->programs)
+            if (!canReuse(itemId, program))
+                program.submit(gl);
+    }
+
     if (mPrevCommandQueue) {
         reuseUnmodifiedItems(*mCommandQueue, *mPrevCommandQueue);
         mPrevCommandQueue.reset();
@@ -61,6 +61,16 @@ bool GLShader::compile(GLContext &gl, PrintfBase &printf)
 {
     if (mShaderObject)
         return true;
+    if (!mPendingShaderObject && !submit(gl, printf))
+        return false;
+    return setShaderObject(gl, std::move(mPendingShaderObject),
+        std::exchange(mPendingFileNames, {}));
+}
+
+bool GLShader::submit(GLContext &gl, PrintfBase &printf)
+{
+    if (mShaderObject || mPendingShaderObject)
+        return true;
     if (mSession.shaderLanguage != Session::ShaderLanguage::GLSL) {
         mMessages.insert(mItemId, MessageType::OpenGLRendererRequiresGLSL);
         return {};
@@ -85,9 +95,12 @@ bool GLShader::compile(GLContext &gl, PrintfBase &printf)
     gl.glShaderSource(shader, static_cast<GLsizei>(sourcePointers.size()),
         sourcePointers.data(), nullptr);
 
+    // status is not queried, so driver can compile in the background
     gl.glCompileShader(shader);
 
-    return setShaderObject(gl, std::move(shader), usedFileNames);
+    mPendingShaderObject = std::move(shader);
+    mPendingFileNames = usedFileNames;
+    return true;
 }
 
 bool GLShader::specialize(GLContext &gl, const Spirv &spirv)
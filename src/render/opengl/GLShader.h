@@ -12,8 +12,12 @@ public:
 
     bool compile(GLContext &gl);
     bool compile(GLContext &gl, PrintfBase &printf);
+    bool submit(GLContext &gl, PrintfBase &printf);
     bool specialize(GLContext &gl, const Spirv &spirv);
-    GLuint shaderObject() const { return mShaderObject; }
+    GLuint shaderObject() const
+    {
+        return (mShaderObject ? mShaderObject : mPendingShaderObject);
+    }
 
 private:
     GLObject createShader(GLContext &gl);
@@ -22,6 +26,8 @@ private:
     QStringList preprocessorDefinitions() const override;
 
     GLObject mShaderObject;
+    GLObject mPendingShaderObject;
+    QStringList mPendingFileNames;
 };
 
 #endif // defined(OPENGL_ENABLED)
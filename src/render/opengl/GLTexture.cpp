@@ -99,7 +99,7 @@ namespace {
                 gl.glGetTexLevelParameteriv(target, level,
                     GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
                 if (glGetError() != GL_NO_ERROR
-                    || size > data.getImageSize(level))
+                    || static_cast<size_t>(size) > data.getImageSize(level))
                     return false;
                 gl.glGetCompressedTexImage(target, level,
                     data.getWriteonlyData(level, 0, 0));
@@ -400,7 +400,7 @@ void GLTexture::createTexture(GLContext &gl)
         auto texture = GLuint{};
         gl.glGenTextures(1, &texture);
 
-        if (mTextureBuffer) {
+        if (mTextureBuffer && mWidth > 0) {
             gl.glBindTexture(mTarget, texture);
             gl.glTexBuffer(mTarget, mFormat,
                 mTextureBuffer->getReadWriteBufferId(gl));
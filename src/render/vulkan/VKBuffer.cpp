@@ -16,7 +16,7 @@ VKBuffer::VKBuffer(const Buffer &buffer, VKRenderSession &renderSession)
         }
 }
 
-VKBuffer::VKBuffer(int size) : BufferBase(size), mUsage(defaultUsage()) { }
+VKBuffer::VKBuffer(qsizetype size) : BufferBase(size), mUsage(defaultUsage()) { }
 
 KDGpu::BufferUsageFlags VKBuffer::defaultUsage() const
 {
@@ -113,7 +113,10 @@ void VKBuffer::reload()
     if (mSize > mData.size())
         mData.append(QByteArray(mSize - mData.size(), 0));
 
-    mSystemCopyModified |= !mData.isSharedWith(prevData);
+    if (!mData.isSharedWith(prevData)) {
+        mSystemCopyModified = true;
+        mDataHash.reset();
+    }
 }
 
 void VKBuffer::createBuffer(KDGpu::Device &device)
@@ -203,9 +206,12 @@ bool VKBuffer::finishDownload()
     auto modified = false;
     if (mDownloadBuffer.isValid()) {
         const auto mappedData = mDownloadBuffer.map();
-        if (!mCheckModification
-            || std::memcmp(mData.data(), mappedData, mData.size()) != 0) {
-            std::memcpy(mData.data(), mappedData, mData.size());
+        const auto hash = (mCheckModification
+                ? std::optional<size_t>(hashData(mappedData))
+                : std::nullopt);
+        if (!hash || *hash != getDataHash()) {
+            std::memcpy(mData.data(), mappedData, mSize);
+            mDataHash = hash;
             modified = true;
         }
         mDownloadBuffer.unmap();
@@ -7,7 +7,7 @@ class VKBuffer : public BufferBase
 {
 public:
     VKBuffer(const Buffer &buffer, VKRenderSession &renderSession);
-    explicit VKBuffer(int size);
+    explicit VKBuffer(qsizetype size);
 
     const KDGpu::Buffer &buffer() const { return mBuffer; }
 
@@ -87,6 +87,9 @@ VKPipeline::VKPipeline(ItemId itemId, VKProgram *program)
     : PipelineBase(itemId)
     , mProgram(*program)
 {
+    for (const auto &shader : mProgram.shaders())
+        for (const auto &name : shader.constantUniforms().keys())
+            mConstantUniforms += name;
 }
 
 VKPipeline::~VKPipeline() = default;
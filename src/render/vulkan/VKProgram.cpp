@@ -68,8 +68,10 @@ bool VKProgram::link(VKContext &context)
             auto inputs = std::vector<ShaderCompiler::Input>();
             inputs.push_back(shader.getShaderCompilerInput(mPrintf));
 
+            auto reused = false;
             auto stages = ShaderCompiler::compileSpirv(mSession, inputs,
-                mItemId, mLinkMessages);
+                mItemId, mLinkMessages, mCompileCache, &reused);
+            mReusedCompilationCount += (reused ? 1 : 0);
             if (stages.empty()) {
                 mFailed = true;
                 return false;
@@ -82,8 +84,10 @@ bool VKProgram::link(VKContext &context)
         for (auto &shader : mShaders)
             inputs.push_back(shader.getShaderCompilerInput(mPrintf));
 
+        auto reused = false;
         auto stages = ShaderCompiler::compileSpirv(mSession, inputs, mItemId,
-            mLinkMessages);
+            mLinkMessages, mCompileCache, &reused);
+        mReusedCompilationCount += (reused ? 1 : 0);
         if (stages.empty()) {
             mFailed = true;
             return false;
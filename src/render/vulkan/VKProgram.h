@@ -19,6 +19,14 @@ public:
     const StageReflection &reflection() const { return mReflection; }
     const std::vector<VKShader> &shaders() const { return mShaders; }
     VKPrintf &printf() { return mPrintf; }
+    void setCompileCache(ShaderCompiler::CompileCache *cache)
+    {
+        mCompileCache = cache;
+    }
+    int resetReusedCompilationCount()
+    {
+        return std::exchange(mReusedCompilationCount, 0);
+    }
 
 private:
     ItemId mItemId{};
@@ -31,6 +39,8 @@ private:
     VKPrintf mPrintf;
     bool mCompileShadersSeparately{};
     bool mFailed{};
+    ShaderCompiler::CompileCache *mCompileCache{};
+    int mReusedCompilationCount{};
 };
 
 #endif // defined(VULKAN_ENABLED)
\ No newline at end of file
@@ -11,8 +11,10 @@
 #include "SynchronizeLogic.h"
 #include "Singletons.h"
 #include "FileCache.h"
+#include "media/MediaManager.h"
 #include "Settings.h"
 #include "editors/EditorManager.h"
+#include "editors/texture/TextureEditor.h"
 #include "editors/qml/QmlView.h"
 #include <QApplication>
 #include <QDirIterator>
@@ -286,8 +288,42 @@ QJSValue AppScriptObject::saveEditor(QString fileName)
 {
     auto saved = false;
     dispatchToMainThread([&]() {
-        if (auto editor = Singletons::editorManager().getEditor(fileName))
+        auto &editorManager = Singletons::editorManager();
+        auto textureEditor = editorManager.getTextureEditor(fileName);
+        if (auto editor = editorManager.getEditor(fileName))
+            saved = (editor->save()
+                && (!textureEditor || textureEditor->waitForSave()));
+    });
+    return saved;
+}
+
+QJSValue AppScriptObject::saveEditor(QString fileName, QJSValue options)
+{
+    auto ktxOptions = TextureData::KtxOptions{ };
+    const auto encoding = options.property("encoding");
+    if (!encoding.isUndefined()) {
+        const auto name = encoding.toString().toLower();
+        if (name == "uastc") {
+            ktxOptions.encoding = TextureData::KtxEncoding::UASTC;
+        } else if (name == "etc1s") {
+            ktxOptions.encoding = TextureData::KtxEncoding::ETC1S;
+        } else if (name != "none") {
+            throwJsError("Invalid KTX encoding '" + name + "'");
+            return false;
+        }
+    }
+    ktxOptions.zstdLevel = options.property("zstd").toInt();
+
+    // options only apply to this save, which is finished before returning
+    auto saved = false;
+    dispatchToMainThread([&]() {
+        auto &editorManager = Singletons::editorManager();
+        if (auto textureEditor = editorManager.getTextureEditor(fileName)) {
+            saved = (textureEditor->save(ktxOptions)
+                && textureEditor->waitForSave());
+        } else if (auto editor = editorManager.getEditor(fileName)) {
             saved = editor->save();
+        }
     });
     return saved;
 }
@@ -481,4 +517,33 @@ QJSValue AppScriptObject::enumerateCameras()
 #else
     return { };
 #endif
-}
\ No newline at end of file
+}
+
+QJSValue AppScriptObject::getFileCacheStatistics()
+{
+    const auto statistics = Singletons::fileCache().statistics();
+    return engine().toJsValue(QVariantMap{
+        { "sourceCount", statistics.sourceCount },
+        { "textureCount", statistics.textureCount },
+        { "binaryCount", statistics.binaryCount },
+        { "sourceBytes", statistics.sourceBytes },
+        { "textureBytes", statistics.textureBytes },
+        { "binaryBytes", statistics.binaryBytes },
+        { "memoryBudget", statistics.memoryBudget },
+        { "hits", statistics.hits },
+        { "misses", statistics.misses },
+        { "evictions", statistics.evictions },
+        { "textureMappedBytes", statistics.textureMappedBytes },
+        { "textureOpenTime", statistics.textureOpenTime },
+    });
+}
+
+double AppScriptObject::getMediaFramesPerSecond(QString fileName)
+{
+    auto framesPerSecond = 0.0;
+    dispatchToMainThread([&]() {
+        framesPerSecond = Singletons::mediaManager().getFramesPerSecond(
+            getAbsolutePath(fileName));
+    });
+    return framesPerSecond;
+}
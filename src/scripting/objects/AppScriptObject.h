@@ -60,6 +60,7 @@ public:
     Q_INVOKABLE bool isUntitled(QString fileName);
     Q_INVOKABLE QString getFileTitle(QString fileName);
     Q_INVOKABLE QJSValue saveEditor(QString fileName);
+    Q_INVOKABLE QJSValue saveEditor(QString fileName, QJSValue options);
     Q_INVOKABLE QJSValue openFileDialog(QString pattern = "");
     Q_INVOKABLE QJSValue saveFileDialog(QString pattern = "");
     Q_INVOKABLE QJSValue loadLibrary(QString fileName);
@@ -72,6 +73,8 @@ public:
     Q_INVOKABLE QJSValue writeBinaryFile(QString fileName, QByteArray binary);
     Q_INVOKABLE QJSValue readTextFile(QString fileName);
     Q_INVOKABLE QJSValue enumerateCameras();
+    Q_INVOKABLE QJSValue getFileCacheStatistics();
+    Q_INVOKABLE double getMediaFramesPerSecond(QString fileName);
 
     // session
     Q_INVOKABLE void clearSession();
@@ -209,6 +209,8 @@ bool shaderCompilerHasSetting(Session::ShaderCompiler compiler,
     case SCS::autoSampledTextures: return (compiler == SC::glslang);
     case SCS::vulkanRulesRelaxed:
         return (compiler == SC::glslang && renderer != R::OpenGL);
+    case SCS::optimizeSpirv:       return (compiler == SC::glslang);
+    case SCS::specializeUniforms:  return (compiler == SC::glslang);
     }
     return false;
 }
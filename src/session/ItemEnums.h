@@ -495,6 +495,8 @@ namespace ItemEnums2 {
         autoSampledTextures,
         vulkanRulesRelaxed,
         spirvVersion,
+        optimizeSpirv,
+        specializeUniforms,
         COUNT,
     };
     Q_ENUM_NS(ShaderCompilerSetting)
@@ -121,6 +121,8 @@ QVariant ShaderCompilerSettingsModel::getColumnDefaultValue(int column) const
     case autoMapLocations:
     case autoSampledTextures:
     case vulkanRulesRelaxed:  return true;
+    case optimizeSpirv:
+    case specializeUniforms:  return false;
     case spirvVersion:        return {};
     case COUNT:               break;
     }
@@ -164,6 +166,10 @@ SessionProperties::SessionProperties(PropertiesEditor *propertiesEditor)
         Session::ShaderCompilerSetting::autoSampledTextures);
     mShaderCompilerSettingsMapper->addMapping(mUi->vulkanRulesRelaxed,
         Session::ShaderCompilerSetting::vulkanRulesRelaxed);
+    mShaderCompilerSettingsMapper->addMapping(mUi->optimizeSpirv,
+        Session::ShaderCompilerSetting::optimizeSpirv);
+    mShaderCompilerSettingsMapper->addMapping(mUi->specializeUniforms,
+        Session::ShaderCompilerSetting::specializeUniforms);
 
     for (auto i = 0; i <= 6; ++i) {
         auto version = QString("1.%1").arg(i);
@@ -363,4 +369,6 @@ void SessionProperties::updateWidgets()
     mUi->autoMapLocations->setVisible(hasSetting(SCS::autoMapLocations));
     mUi->autoSampledTextures->setVisible(hasSetting(SCS::autoSampledTextures));
     mUi->vulkanRulesRelaxed->setVisible(hasSetting(SCS::vulkanRulesRelaxed));
+    mUi->optimizeSpirv->setVisible(hasSetting(SCS::optimizeSpirv));
+    mUi->specializeUniforms->setVisible(hasSetting(SCS::specializeUniforms));
 }
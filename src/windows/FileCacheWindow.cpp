@@ -0,0 +1,89 @@
+#include "FileCacheWindow.h"
+#include "FileCache.h"
+#include "Singletons.h"
+#include <QHeaderView>
+#include <QLocale>
+#include <QTimer>
+
+FileCacheWindow::FileCacheWindow(QWidget *parent)
+    : QTableWidget(parent)
+    , mUpdateTimer(new QTimer(this))
+{
+    connect(mUpdateTimer, &QTimer::timeout, this,
+        &FileCacheWindow::updateStatistics);
+    mUpdateTimer->setInterval(500);
+
+    setColumnCount(2);
+    verticalHeader()->setVisible(false);
+    horizontalHeader()->setVisible(false);
+    verticalHeader()->setDefaultSectionSize(20);
+    horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
+    horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    setEditTriggers(NoEditTriggers);
+    setSelectionMode(NoSelection);
+    setShowGrid(false);
+    setAlternatingRowColors(true);
+}
+
+void FileCacheWindow::showEvent(QShowEvent *event)
+{
+    updateStatistics();
+    mUpdateTimer->start();
+    QTableWidget::showEvent(event);
+}
+
+void FileCacheWindow::hideEvent(QHideEvent *event)
+{
+    mUpdateTimer->stop();
+    QTableWidget::hideEvent(event);
+}
+
+void FileCacheWindow::setRow(int row, const QString &name,
+    const QString &value)
+{
+    if (row >= rowCount()) {
+        setRowCount(row + 1);
+        setItem(row, 0, new QTableWidgetItem(name));
+        setItem(row, 1, new QTableWidgetItem());
+    }
+    item(row, 1)->setText(value);
+}
+
+void FileCacheWindow::updateStatistics()
+{
+    const auto statistics = Singletons::fileCache().statistics();
+    const auto locale = QLocale();
+    const auto files = [&](int count, qint64 bytes) {
+        return tr("%1 files, %2").arg(count).arg(
+            locale.formattedDataSize(bytes));
+    };
+    const auto accesses = statistics.hits + statistics.misses;
+
+    auto row = 0;
+    setRow(row++, tr("Sources"),
+        files(statistics.sourceCount, statistics.sourceBytes));
+    setRow(row++, tr("Textures"),
+        files(statistics.textureCount, statistics.textureBytes));
+    setRow(row++, tr("Mapped Textures"),
+        locale.formattedDataSize(statistics.textureMappedBytes));
+    setRow(row++, tr("Texture Open Time"),
+        QStringLiteral("%1 ms").arg(statistics.textureOpenTime));
+    setRow(row++, tr("Binaries"),
+        files(statistics.binaryCount, statistics.binaryBytes));
+    setRow(row++, tr("Total"),
+        files(statistics.sourceCount + statistics.textureCount
+                + statistics.binaryCount,
+            statistics.sourceBytes + statistics.textureBytes
+                + statistics.binaryBytes));
+    setRow(row++, tr("Budget"),
+        statistics.memoryBudget > 0
+            ? locale.formattedDataSize(statistics.memoryBudget)
+            : tr("Unlimited"));
+    setRow(row++, tr("Hits"), QString::number(statistics.hits));
+    setRow(row++, tr("Misses"), QString::number(statistics.misses));
+    setRow(row++, tr("Hit Rate"),
+        accesses ? QStringLiteral("%1 %").arg(
+                       100.0 * statistics.hits / accesses, 0, 'f', 1)
+                 : QStringLiteral("-"));
+    setRow(row++, tr("Evictions"), QString::number(statistics.evictions));
+}
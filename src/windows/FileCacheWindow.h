@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QTableWidget>
+
+class QTimer;
+
+class FileCacheWindow final : public QTableWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FileCacheWindow(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateStatistics();
+    void setRow(int row, const QString &name, const QString &value);
+
+    QTimer *mUpdateTimer{};
+};
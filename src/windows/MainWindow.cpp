@@ -2,6 +2,7 @@
 #include "AboutDialog.h"
 #include "AutoOrientationSplitter.h"
 #include "FileBrowserWindow.h"
+#include "FileCacheWindow.h"
 #include "MessageWindow.h"
 #include "OutputWindow.h"
 #include "Settings.h"
@@ -27,6 +28,7 @@
 #include <QCloseEvent>
 #include <QDesktopServices>
 #include <QDockWidget>
+#include <QLocale>
 #include <QMimeData>
 #include <QToolButton>
 
@@ -40,6 +42,25 @@ void setFileDialogDirectory(const QString &fileName)
         Singletons::fileDialog().setDirectory(QFileInfo(fileName).dir());
 }
 
+// load files while the first evaluation is prepared
+void prefetchSessionFiles(const SessionModel &model)
+{
+    auto &fileCache = Singletons::fileCache();
+    const auto &session = model.sessionItem();
+    model.forEachFileItem([&](const FileItem &item) {
+        if (castItem<Texture>(item)) {
+            fileCache.prefetchTexture(item.fileName);
+        } else if (castItem<Buffer>(item)) {
+            fileCache.prefetchBinary(item.fileName);
+        } else if (auto shader = castItem<Shader>(item)) {
+            fileCache.prefetchSource(item.fileName,
+                session.shaderIncludePaths + '\n' + shader->includePaths);
+        } else if (castItem<Script>(item)) {
+            fileCache.prefetchSource(item.fileName);
+        }
+    });
+}
+
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , mUi(new Ui::MainWindow)
@@ -47,6 +68,7 @@ MainWindow::MainWindow(QWidget *parent)
     , mSingletons(new Singletons(this))
     , mOutputWindow(std::make_unique<OutputWindow>())
     , mFileBrowserWindow(std::make_unique<FileBrowserWindow>())
+    , mFileCacheWindow(std::make_unique<FileCacheWindow>())
     , mEditorManager(Singletons::editorManager())
     , mSessionEditor(std::make_unique<SessionEditor>())
     , mPropertiesEditor(std::make_unique<PropertiesEditor>())
@@ -188,6 +210,20 @@ MainWindow::MainWindow(QWidget *parent)
     splitDockWidget(editorsDock, dock, Qt::Horizontal);
     auto outputDock = dock;
 
+    dock = new QDockWidget(tr("File Cache"), this);
+    dock->setObjectName("FileCache");
+    dock->setTitleBarWidget(new WindowTitle(dock));
+    dock->setWidget(mFileCacheWindow.get());
+    dock->setVisible(false);
+    dock->setMinimumSize(150, 150);
+    dock->setSizePolicy({ QSizePolicy::Fixed, QSizePolicy::Fixed });
+    action = dock->toggleViewAction();
+    action->setObjectName("toggle" + dock->objectName());
+    action->setText(tr("Show &") + action->text());
+    action->setIcon(QIcon::fromTheme("drive-harddisk"));
+    mUi->menuView->addAction(action);
+    splitDockWidget(mSessionDock, dock, Qt::Vertical);
+
     mUi->toolBarMain->insertSeparator(mUi->actionEvalReset);
 
     mUi->actionQuit->setShortcuts(QKeySequence::Quit);
@@ -388,6 +424,67 @@ MainWindow::MainWindow(QWidget *parent)
         ++i;
     }
 
+    auto fileCacheBudgetActionGroup = new QActionGroup(this);
+    connect(fileCacheBudgetActionGroup, &QActionGroup::triggered,
+        [](QAction *a) {
+            Singletons::settings().setFileCacheBudget(a->data().toInt());
+        });
+    for (auto megabytes : { 512, 1024, 2048, 4096, 8192, 16384, 0 }) {
+        auto action = mUi->menuFileCacheBudget->addAction(megabytes
+                ? QLocale().formattedDataSize(qint64{ megabytes } << 20)
+                : tr("Unlimited"));
+        action->setData(megabytes);
+        action->setCheckable(true);
+        action->setChecked(megabytes == settings.fileCacheBudget());
+        action->setActionGroup(fileCacheBudgetActionGroup);
+        if (megabytes == 16384)
+            mUi->menuFileCacheBudget->addSeparator();
+    }
+
+    auto mipmapFilterActionGroup = new QActionGroup(this);
+    connect(mipmapFilterActionGroup, &QActionGroup::triggered,
+        [](QAction *a) {
+            Singletons::settings().setMipmapFilter(a->data().toInt());
+        });
+    i = 0;
+    for (const auto &text :
+        { tr("None (Device)"), tr("Box"), tr("Kaiser"), tr("Lanczos") }) {
+        auto action = mUi->menuMipmapFilter->addAction(text);
+        action->setData(i);
+        action->setCheckable(true);
+        action->setChecked(i == settings.mipmapFilter());
+        action->setActionGroup(mipmapFilterActionGroup);
+        ++i;
+    }
+    mUi->menuMipmapFilter->addSeparator();
+    auto mipmapSRGBAction =
+        mUi->menuMipmapFilter->addAction(tr("sRGB Correct"));
+    mipmapSRGBAction->setCheckable(true);
+    mipmapSRGBAction->setChecked(settings.mipmapSRGB());
+    connect(mipmapSRGBAction, &QAction::toggled, &settings,
+        &Settings::setMipmapSRGB);
+    auto mipmapAlphaCoverageAction =
+        mUi->menuMipmapFilter->addAction(tr("Preserve Alpha Coverage"));
+    mipmapAlphaCoverageAction->setCheckable(true);
+    mipmapAlphaCoverageAction->setChecked(settings.mipmapAlphaCoverage());
+    connect(mipmapAlphaCoverageAction, &QAction::toggled, &settings,
+        &Settings::setMipmapAlphaCoverage);
+
+    auto textureCompressionActionGroup = new QActionGroup(this);
+    connect(textureCompressionActionGroup, &QActionGroup::triggered,
+        [](QAction *a) {
+            Singletons::settings().setTextureCompression(a->data().toInt());
+        });
+    i = 0;
+    for (const auto &text : { tr("Fast"), tr("Normal"), tr("High") }) {
+        auto action = mUi->menuTextureCompression->addAction(text);
+        action->setData(i);
+        action->setCheckable(true);
+        action->setChecked(i == settings.textureCompression());
+        action->setActionGroup(textureCompressionActionGroup);
+        ++i;
+    }
+
     auto indentActionGroup = new QActionGroup(this);
     connect(indentActionGroup, &QActionGroup::triggered, [](QAction *a) {
         Singletons::settings().setTabSize(a->data().toInt());
@@ -912,6 +1009,8 @@ bool MainWindow::openSession(const QString &fileName)
     if (!mSessionEditor->load())
         return false;
 
+    prefetchSessionFiles(Singletons::sessionModel());
+
     Singletons::synchronizeLogic().handleSessionFileNameChanged(fileName);
 
     if (!restoreSessionState(fileName)) {
@@ -17,6 +17,7 @@ class Singletons;
 class MessageWindow;
 class OutputWindow;
 class FileBrowserWindow;
+class FileCacheWindow;
 class EditorManager;
 class SessionEditor;
 class PropertiesEditor;
@@ -106,6 +107,7 @@ private:
     std::unique_ptr<Singletons> mSingletons;
     std::unique_ptr<OutputWindow> mOutputWindow;
     std::unique_ptr<FileBrowserWindow> mFileBrowserWindow;
+    std::unique_ptr<FileCacheWindow> mFileCacheWindow;
     EditorManager &mEditorManager;
     std::unique_ptr<SessionEditor> mSessionEditor;
     QDockWidget *mSessionDock{};
@@ -29,6 +29,11 @@ OutputWindow::OutputWindow(QWidget *parent)
     mTypeSelector->addItem(tr("SPIR-V → GLSL"), "glsl");
     mTypeSelector->addItem(tr("SPIR-V → HLSL"), "hlsl");
     mTypeSelector->addItem(tr("SPIR-V"), "spirv");
+    mTypeSelector->addItem(tr("SPIR-V Optimized (-O)"), "spirvOptimized");
+    mTypeSelector->addItem(tr("SPIR-V Optimized (-Os)"), "spirvOptimizedSize");
+    mTypeSelector->addItem(tr("SPIR-V Statistics"), "statistics");
+    mTypeSelector->addItem(tr("SPIR-V Statistics (-O)"),
+        "statisticsOptimized");
     mTypeSelector->addItem(tr("glslang AST"), "ast");
     mTypeSelector->addItem(tr("Program Binary (NV_gpu_program)"),
         "programBinary");